@@ -27,16 +27,57 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <deque>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CLP_SSE2
+#endif
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
 #include <Windows.h>
 #else
+#include <dirent.h>
+#include <fcntl.h>
 #include <libgen.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 /**
@@ -44,372 +85,5172 @@
  *  - Currently, when an option is required there is no way to implement direct exit options like version
  * **/
 
-class CommandLineOption
+class CommandLineHash
 {
 public:
-	enum class HasValue
-	{
-		Yes,
-		No
-	};
-
-	enum class Required
-	{
-		Yes,
-		No
-	};
+	static constexpr uint64_t SEED = 14695981039346656037ull;
 
-	enum class Separator
+	// FNV-1a, the seed allows to chain multiple calls
+	static uint64_t fnv1a(const std::string_view& data, uint64_t hash = SEED)
 	{
-		Yes,
-		No
-	};
+		for (const char& c : data)
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
 
-public:
-	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc,
-					  const std::string& defaultValue, const HasValue& hasValue, const Required& required, const Separator& separator) :
-		m_arg(arg),
-		m_argAlt(argAlt),
-		m_desc(desc),
-		m_default(defaultValue),
-		m_required(required == Required::Yes),
-		m_hasValue(hasValue == HasValue::Yes),
-		m_isSeparator(separator == Separator::Yes)
-	{
+		return hash;
 	}
 
-	CommandLineOption(const char* pArg, const char* pArgAlt, const char* pDesc, const char* pDefaultValue,
-					  const HasValue& hasValue, const Required& required, const Separator& separator) :
-		CommandLineOption(std::string(pArg), std::string(pArgAlt), std::string(pDesc), std::string(pDefaultValue), hasValue, required, separator)
+	static uint64_t fnv1a(const uint64_t& value, const uint64_t& hash = SEED)
 	{
+		return fnv1a(std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)), hash);
 	}
+};
 
-	// If a default value is set, the option has to have a value
-	// When calling the constructor with a plain char* as default parameter, e.g., "DEFAULT"
-	// not the std::string constructor would be used, but the one for hasValue, because converting
-	// from char* to bool is a standard conversion, while char* to std::string is a user-defined conversion
-	// See: https://stackoverflow.com/a/26414524
-	// Therefore, a char* based constructor is available.
-	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const char* pDefault, const Required& required = Required::No) :
-		CommandLineOption(arg, argAlt, desc, std::string(pDefault), required)
+// Simple LZ77 style compression, e.g., for rarely used help texts. The data consists of tokens
+// starting with a control byte: 0-127 are followed by 1-128 literal bytes, 128-255 encode a
+// match of 4-131 bytes followed by a 2 byte offset into the already decompressed data.
+class CommandLineCompression
+{
+public:
+	static std::vector<uint8_t> compress(const std::string_view& data)
 	{
-	}
+		const size_t minMatch  = 4;
+		const size_t maxMatch  = 131;
+		const size_t maxOffset = 65535;
 
-	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const std::string& defaultValue, const Required& required = Required::No) :
-		CommandLineOption(arg, argAlt, desc, defaultValue, HasValue::Yes, required, Separator::No)
-	{
-	}
+		std::vector<uint8_t> out;
+		std::vector<size_t> table(4096, NO_POS);
+		size_t literals = 0;
+		size_t pos      = 0;
 
-	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const HasValue& hasValue = HasValue::Yes, const Required& required = Required::No) :
-		CommandLineOption(arg, argAlt, desc, "", hasValue, required, Separator::No)
-	{
-	}
+		out.reserve(data.size() / 2 + 16);
 
-	bool check(const std::string& arg)
-	{
-		// Do not expect the same option to be selected twice ...
-		// This is required to prevent set parameters from being
-		// overritten by following checks against different parameters
-		if (m_set)
-			return false;
+		while (pos < data.size())
+		{
+			size_t length = 0;
 
-		std::stringstream ss(m_argAlt);
-		std::string argAltArg = "";
-		if (!ss.eof())
-			ss >> argAltArg;
+			if (pos + minMatch <= data.size())
+			{
+				uint32_t seq;
+				std::memcpy(&seq, data.data() + pos, sizeof(seq));
 
-		if (!m_arg.empty())
-			m_set = m_arg == arg;
+				const size_t hash = (seq * 2654435761u) >> 20;
+				const size_t cand = table[hash];
+				table[hash]       = pos;
 
-		if (!m_set && !argAltArg.empty())
-			m_set = argAltArg == arg;
+				if (cand != NO_POS && pos - cand <= maxOffset)
+				{
+					while (pos + length < data.size() && length < maxMatch && data[cand + length] == data[pos + length])
+						length++;
+				}
 
-		return m_set;
-	}
+				if (length >= minMatch)
+				{
+					flushLiterals(out, data, pos, literals);
+					out.push_back(static_cast<uint8_t>(0x80 | (length - minMatch)));
+					out.push_back(static_cast<uint8_t>((pos - cand) & 0xFF));
+					out.push_back(static_cast<uint8_t>((pos - cand) >> 8));
+					pos += length;
+					continue;
+				}
+			}
 
-	bool isSet() const
-	{
-		// In case a default value has been set (default not empty) return true
-		return (m_set || !(m_default.empty()));
-	}
+			literals++;
+			pos++;
 
-	void setValue(const std::string& value)
-	{
-		m_value = value;
+			if (literals == 128)
+				flushLiterals(out, data, pos, literals);
+		}
+
+		flushLiterals(out, data, pos, literals);
+
+		return out;
 	}
 
-	const std::string& getValue() const
+	static std::string decompress(const std::vector<uint8_t>& data)
 	{
-		if (m_set)
-			return m_value;
-		else
-			return m_default;
+		std::string out;
+		size_t pos = 0;
+
+		while (pos < data.size())
+		{
+			const uint8_t ctrl = data[pos++];
+
+			if (ctrl < 0x80)
+			{
+				const size_t count = (std::min)(static_cast<size_t>(ctrl) + 1, data.size() - pos);
+				out.append(reinterpret_cast<const char*>(data.data() + pos), count);
+				pos += count;
+			}
+			else
+			{
+				if (pos + 2 > data.size())
+					break;
+
+				const size_t length = (ctrl & 0x7F) + 4;
+				const size_t offset = data[pos] | (static_cast<size_t>(data[pos + 1]) << 8);
+				pos += 2;
+
+				if (offset == 0 || offset > out.size())
+					break;
+
+				// Matches may overlap the data they produce, therefore, copy byte by byte
+				for (size_t i = 0; i < length; i++)
+					out.push_back(out[out.size() - offset]);
+			}
+		}
+
+		return out;
 	}
 
-	bool isRequired() const
+private:
+	static constexpr size_t NO_POS = static_cast<size_t>(-1);
+
+	static void flushLiterals(std::vector<uint8_t>& out, const std::string_view& data, const size_t& pos, size_t& literals)
 	{
-		return m_required;
+		if (literals == 0)
+			return;
+
+		out.push_back(static_cast<uint8_t>(literals - 1));
+		out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(pos - literals), data.begin() + static_cast<std::ptrdiff_t>(pos));
+		literals = 0;
 	}
+};
 
-	void setRequired(const bool& required)
+// Host properties intended to be used as lazy default values, e.g.:
+// CLO("-t", "--threads", "Number of threads", HostInfo::provider(HostInfo::cpuQuota))
+class HostInfo
+{
+public:
+	static size_t cpuCount()
 	{
-		m_required = required;
+#ifdef _WIN32
+		return (std::max)(1u, std::thread::hardware_concurrency());
+#else
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		return cpus > 0 ? static_cast<size_t>(cpus) : 1;
+#endif
 	}
 
-	bool hasValue() const
+	// Number of CPUs usable according to the cgroup v2 CPU quota (rounded up)
+	static size_t cpuQuota()
 	{
-		return m_hasValue;
+		const size_t cpus = cpuCount();
+		std::istringstream ss(readCgroupFile("cpu.max"));
+		std::string quota;
+		size_t period = 0;
+
+		if (!(ss >> quota >> period) || quota == "max" || period == 0)
+			return cpus;
+
+		const size_t limit = (std::strtoull(quota.c_str(), nullptr, 10) + period - 1) / period;
+		return (std::max)(static_cast<size_t>(1), (std::min)(cpus, limit));
 	}
 
-	void setSpaceAdd(const size_t& spaceAdd)
+	static size_t memorySize()
 	{
-		m_addSpace = spaceAdd;
+#ifdef _WIN32
+		MEMORYSTATUSEX status;
+		status.dwLength = sizeof(status);
+		return GlobalMemoryStatusEx(&status) ? static_cast<size_t>(status.ullTotalPhys) : 0;
+#else
+		long pages    = sysconf(_SC_PHYS_PAGES);
+		long pageSize = sysconf(_SC_PAGE_SIZE);
+		return (pages > 0 && pageSize > 0) ? static_cast<size_t>(pages) * static_cast<size_t>(pageSize) : 0;
+#endif
 	}
 
-	const std::string& getArg() const
+	// Memory usable according to the cgroup v2 memory limit
+	static size_t memoryLimit()
 	{
-		return m_arg;
+		const size_t memory = memorySize();
+		const std::string limit = readCgroupFile("memory.max");
+
+		if (limit.empty() || limit.compare(0, 3, "max") == 0)
+			return memory;
+
+		return (std::min)(memory, static_cast<size_t>(std::strtoull(limit.c_str(), nullptr, 10)));
 	}
 
-	const std::string& getArgAlt() const
+	static size_t numaNodeCount()
 	{
-		return m_argAlt;
+		size_t nodes = 0;
+
+		for (const std::pair<size_t, size_t>& range : readRangeList("/sys/devices/system/node/online"))
+			nodes += range.second - range.first + 1;
+
+		return (std::max)(static_cast<size_t>(1), nodes);
 	}
 
-	void setDefault(const std::string& defaultValue)
+	static std::function<std::string()> provider(size_t (*pFunc)())
 	{
-		m_default = defaultValue;
+		return [pFunc]() { return std::to_string(pFunc()); };
 	}
 
-	const std::string& getDefault() const
+	static std::string readFile(const std::string& path)
 	{
-		return m_default;
+		std::ifstream file(path);
+		std::string content;
+		std::getline(file, content, '\0');
+		return content;
 	}
 
-	friend std::ostream& operator<<(std::ostream& os, const CommandLineOption& clo)
+	// Parses a sysfs style range list, e.g., "0-3,8,10-11"
+	static std::vector<std::pair<size_t, size_t>> readRangeList(const std::string& path)
 	{
-		// Windows cmd default width is 80
-		const size_t maxLineLen = 80;
-
-		const size_t spaceArgDesc = 4;
+		std::vector<std::pair<size_t, size_t>> ranges;
+		std::istringstream ss(readFile(path));
+		std::string item;
 
-		if (clo.m_isSeparator)
-			os << std::endl;
-		else
+		while (std::getline(ss, item, ','))
 		{
-			std::string argStr(clo.m_arg + ", " + clo.m_argAlt);
-			os << std::left << std::setfill(' ') << std::setw(clo.m_addSpace) << argStr;
-			os << std::setfill(' ') << std::setw(spaceArgDesc) << "";
-
-			std::string desc = clo.m_desc;
+			char* pEnd         = nullptr;
+			const size_t first = std::strtoull(item.c_str(), &pEnd, 10);
 
-			if (clo.m_required)
-				desc.append(" (required)");
-
-			if (!(clo.m_default.empty()))
-			{
-				desc.append(" DEFAULT: ");
-				desc.append(clo.m_default);
-			}
-
-			while (desc.length() + spaceArgDesc + clo.m_addSpace > maxLineLen)
-			{
-				size_t spacePos = desc.find_last_of(' ', maxLineLen - (spaceArgDesc + clo.m_addSpace));
-				os << desc.substr(0, spacePos) << std::endl;
-				os << std::setfill(' ') << std::setw(spaceArgDesc + clo.m_addSpace) << "";
-				desc = desc.substr(spacePos + 1);
-			}
+			if (pEnd == item.c_str())
+				continue;
 
-			os << desc << std::endl;
+			ranges.push_back({ first, *pEnd == '-' ? std::strtoull(pEnd + 1, nullptr, 10) : first });
 		}
 
-		return os;
+		return ranges;
 	}
 
-	bool operator==(const CommandLineOption& rhs) const
+private:
+	static std::string readCgroupFile(const std::string& name)
 	{
-		if (this == &rhs)
-			return true;
+		// The cgroup of the process is listed as "0::<path>" for cgroup v2
+		std::ifstream cgroups("/proc/self/cgroup");
+		std::string line;
 
-		return m_arg == rhs.m_arg && m_argAlt == rhs.m_argAlt && m_desc == rhs.m_desc;
-	}
+		while (std::getline(cgroups, line))
+		{
+			if (line.compare(0, 3, "0::") != 0)
+				continue;
 
-	size_t getArgsLength() const
-	{
-		if (m_isSeparator) return 0;
+			std::string content = readFile("/sys/fs/cgroup" + line.substr(3) + "/" + name);
 
-		return std::string(m_arg + ", " + m_argAlt).size();
-	}
+			if (!content.empty())
+				return content;
+		}
 
-private:
-	std::string m_arg;
-	std::string m_argAlt;
-	std::string m_desc;
-	std::string m_value = "";
-	std::string m_default;
-	bool m_set = false;
-	bool m_required;
-	bool m_hasValue;
-	bool m_isSeparator;
-	size_t m_addSpace = 0;
+		return readFile("/sys/fs/cgroup/" + name);
+	}
 };
 
-using CLO = CommandLineOption;
-
-class CommandLineParser
+// Syntactic parsing of IP addresses, endpoints (host:port) and networks (CIDR notation) into
+// binary structures, without any name resolution
+class CommandLineNetwork
 {
-	using CommandLineOptions = std::deque<CommandLineOption>;
-
 public:
-	CommandLineParser(const int argc, char** argv) :
-		m_options(),
-		m_argc(argc),
-		m_argv(argv),
-		m_helpOpt(CommandLineOption("-h", "--help", "Displays Help", CLO::HasValue::No))
+	struct Address
 	{
-	}
+		uint8_t family    = 0; // 4 or 6
+		uint8_t bytes[16] = {}; // Network byte order, IPv4 addresses use the first 4 bytes
+	};
 
-	CommandLineParser(const CommandLineParser&) = delete;            // disable copy constructor
-	CommandLineParser& operator=(const CommandLineParser&) = delete; //  disable assignment constructor
+	// Either [IPv6]:port, IPv4:port or hostname:port
+	struct Endpoint
+	{
+		Address address;       // Family 0 if a host name is used
+		std::string_view host; // Refers to the parsed string
+		uint16_t port = 0;
+	};
 
-	void addOption(const CommandLineOption& opt)
+	struct Network
 	{
-		m_options.push_back(opt);
-	}
+		Address address;
+		uint8_t prefix = 0;
+	};
 
-	void addSeparator()
+	struct Error
 	{
-		m_options.push_back(CommandLineOption("", "", "", "", CLO::HasValue::No, CLO::Required::No, CLO::Separator::Yes));
-	}
+		size_t index;  // Index of the element in the list
+		size_t offset; // Byte offset of the element in the parsed string
+	};
 
-	void addHelpOption()
+	template<typename T>
+	struct List
+	{
+		std::vector<T> items; // Only the valid elements
+		std::vector<Error> errors;
+	};
+
+public:
+	static bool parse(const std::string_view& str, Address& address)
 	{
-		m_options.push_front(m_helpOpt);
+		if (str.find(':') != std::string_view::npos)
+			address.family = parseIPv6(str, address.bytes) ? 6 : 0;
+		else
+			address.family = parseIPv4(str, address.bytes) ? 4 : 0;
+
+		return address.family != 0;
 	}
 
-	void parse(const bool& requireMatch = true)
+	static bool parse(const std::string_view& str, Endpoint& endpoint)
 	{
-		bool anyMatch       = false;
-		bool allRequiredSet = true;
+		size_t colon = 0;
 
-		for (int i = 1; i < m_argc; i++)
+		endpoint.address.family = 0;
+		endpoint.host           = std::string_view();
+
+		if (!str.empty() && str.front() == '[')
 		{
-			std::string str = m_argv[i];
+			const size_t close = str.find(']');
 
-			for (CommandLineOption& option : m_options)
-			{
-				if (option.check(str))
-				{
-					if (option.hasValue())
-					{
-						i++;
-						option.setValue(m_argv[i]);
-					}
+			if (close == std::string_view::npos || !parseIPv6(str.substr(1, close - 1), endpoint.address.bytes))
+				return false;
 
-					anyMatch = true;
-				}
-			}
-		}
+			endpoint.address.family = 6;
+			colon                   = close + 1;
 
-		if (isSet(m_helpOpt) || (!anyMatch && requireMatch))
-		{
-			printHelp();
-			exit(0);
+			if (colon >= str.size() || str[colon] != ':')
+				return false;
 		}
-
-		for (CommandLineOption& option : m_options)
+		else
 		{
-			if (option.isRequired() && !option.isSet())
-			{
-				std::cerr << "ERROR: Required option (" << option.getArg() << " / " << option.getArgAlt() << ") not set, exiting ..." << std::endl;
-				allRequiredSet = false;
-			}
+			colon = str.find(':');
+
+			if (colon == std::string_view::npos || str.find(':', colon + 1) != std::string_view::npos)
+				return false;
+
+			const std::string_view host = str.substr(0, colon);
+
+			if (parseIPv4(host, endpoint.address.bytes))
+				endpoint.address.family = 4;
+			else if (isHostName(host))
+				endpoint.host = host;
+			else
+				return false;
 		}
 
-		if (!allRequiredSet)
-			exit(-1);
+		return parsePort(str.substr(colon + 1), endpoint.port);
 	}
 
-	bool isSet(const CommandLineOption& opt) const
+	// A missing prefix length is treated as a single address network
+	static bool parse(const std::string_view& str, Network& network)
 	{
-		CommandLineOptions::const_iterator result = std::find(m_options.begin(), m_options.end(), opt);
+		const size_t slash = str.find('/');
 
-		if (result == m_options.end())
+		if (!parse(str.substr(0, slash), network.address))
 			return false;
-		else
-			return result->isSet();
-	}
 
-	std::string getValue(const CommandLineOption& opt) const
-	{
-		CommandLineOptions::const_iterator result = std::find(m_options.begin(), m_options.end(), opt);
+		const size_t maxPrefix = network.address.family == 4 ? 32 : 128;
 
-		if (result == m_options.end())
-			return "";
-		else
-			return result->getValue();
+		if (slash == std::string_view::npos)
+		{
+			network.prefix = static_cast<uint8_t>(maxPrefix);
+			return true;
+		}
+
+		const std::string_view prefix = str.substr(slash + 1);
+		size_t value                  = 0;
+
+		if (prefix.empty() || prefix.size() > 3)
+			return false;
+
+		for (const char& c : prefix)
+		{
+			if (c < '0' || c > '9')
+				return false;
+
+			value = value * 10 + static_cast<size_t>(c - '0');
+		}
+
+		network.prefix = static_cast<uint8_t>(value);
+
+		return value <= maxPrefix;
 	}
 
-	std::vector<std::string> getValueList(const CommandLineOption& opt, const std::string delim = ",") const
+	// Parses all elements of the list into one contiguous array, surrounding spaces are ignored
+	template<typename T>
+	static List<T> parseList(const std::string_view& str, const char& delim = ',')
 	{
-		CommandLineOptions::const_iterator result = std::find(m_options.begin(), m_options.end(), opt);
+		List<T> list;
+		size_t index = 0;
+		size_t pos   = 0;
 
-		if (result == m_options.end())
+		list.items.reserve(static_cast<size_t>(std::count(str.begin(), str.end(), delim)) + 1);
+
+		while (pos <= str.size())
+		{
+			size_t end = str.find(delim, pos);
+
+			if (end == std::string_view::npos)
+				end = str.size();
+
+			size_t first = pos;
+			size_t last  = end;
+
+			while (first < last && str[first] == ' ')
+				first++;
+
+			while (last > first && str[last - 1] == ' ')
+				last--;
+
+			T item;
+
+			if (parse(str.substr(first, last - first), item))
+				list.items.push_back(item);
+			else
+				list.errors.push_back({ index, first });
+
+			index++;
+			pos = end + 1;
+		}
+
+		return list;
+	}
+
+	static bool parseIPv4(const std::string_view& str, uint8_t* pOut)
+	{
+		size_t pos = 0;
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			if (i > 0 && (pos >= str.size() || str[pos++] != '.'))
+				return false;
+
+			const size_t start = pos;
+			unsigned value     = 0;
+
+			while (pos < str.size() && pos - start < 3 && str[pos] >= '0' && str[pos] <= '9')
+				value = value * 10 + static_cast<unsigned>(str[pos++] - '0');
+
+			// Leading zeros are rejected, as they are interpreted as octal by some parsers
+			if (pos == start || value > 255 || (pos - start > 1 && str[start] == '0'))
+				return false;
+
+			pOut[i] = static_cast<uint8_t>(value);
+		}
+
+		return pos == str.size();
+	}
+
+	static bool parseIPv6(const std::string_view& str, uint8_t* pOut)
+	{
+		uint8_t bytes[16] = {};
+		size_t count      = 0;
+		size_t gap        = NO_GAP;
+		size_t pos        = 0;
+
+		if (str.size() >= 2 && str[0] == ':' && str[1] == ':')
+		{
+			gap = 0;
+			pos = 2;
+		}
+
+		while (pos < str.size())
+		{
+			size_t end = str.find(':', pos);
+
+			if (end == std::string_view::npos)
+				end = str.size();
+
+			const std::string_view group = str.substr(pos, end - pos);
+
+			// An embedded IPv4 address is only allowed as the last 4 bytes
+			if (group.find('.') != std::string_view::npos)
+			{
+				if (end != str.size() || count > 12 || !parseIPv4(group, bytes + count))
+					return false;
+
+				count += 4;
+				break;
+			}
+
+			if (group.empty() || group.size() > 4 || count == 16)
+				return false;
+
+			unsigned value = 0;
+
+			for (const char& c : group)
+			{
+				const int digit = hexDigit(c);
+
+				if (digit < 0)
+					return false;
+
+				value = (value << 4) | static_cast<unsigned>(digit);
+			}
+
+			bytes[count++] = static_cast<uint8_t>(value >> 8);
+			bytes[count++] = static_cast<uint8_t>(value & 0xFF);
+			pos            = end;
+
+			if (pos == str.size())
+				break;
+
+			if (++pos < str.size() && str[pos] == ':')
+			{
+				if (gap != NO_GAP)
+					return false;
+
+				gap = count;
+				pos++;
+			}
+			else if (pos == str.size())
+				return false;
+		}
+
+		if (gap == NO_GAP && count != 16)
+			return false;
+
+		if (gap != NO_GAP)
+		{
+			// "::" has to replace at least one group
+			if (count == 16)
+				return false;
+
+			const size_t tail = count - gap;
+			std::memmove(bytes + 16 - tail, bytes + gap, tail);
+			std::memset(bytes + gap, 0, 16 - tail - gap);
+		}
+
+		std::memcpy(pOut, bytes, sizeof(bytes));
+
+		return true;
+	}
+
+private:
+	static constexpr size_t NO_GAP = static_cast<size_t>(-1);
+
+	static int hexDigit(const char& c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		else if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		else
+			return -1;
+	}
+
+	static bool parsePort(const std::string_view& str, uint16_t& port)
+	{
+		unsigned value = 0;
+
+		if (str.empty() || str.size() > 5)
+			return false;
+
+		for (const char& c : str)
+		{
+			if (c < '0' || c > '9')
+				return false;
+
+			value = value * 10 + static_cast<unsigned>(c - '0');
+		}
+
+		port = static_cast<uint16_t>(value);
+
+		return value <= 65535;
+	}
+
+	// Labels of letters, digits and hyphens, not starting or ending with a hyphen. The last label
+	// must not be all-numeric (RFC 3696), so invalid IPv4 addresses like 999.1.1.1 are rejected.
+	static bool isHostName(const std::string_view& str)
+	{
+		size_t labelLength = 0;
+		bool numeric       = true;
+
+		if (str.empty() || str.size() > 253)
+			return false;
+
+		for (size_t i = 0; i < str.size(); i++)
+		{
+			const char c = str[i];
+
+			if (c == '.')
+			{
+				if (labelLength == 0 || str[i - 1] == '-')
+					return false;
+
+				labelLength = 0;
+				numeric     = true;
+				continue;
+			}
+
+			const bool digit = c >= '0' && c <= '9';
+			const bool alnum = digit || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+
+			if (!(alnum || (c == '-' && labelLength > 0)) || ++labelLength > 63)
+				return false;
+
+			numeric &= digit;
+		}
+
+		return labelLength > 0 && str.back() != '-' && !numeric;
+	}
+};
+
+// Decoding of binary values given as hex or base64 strings
+class CommandLineEncoding
+{
+private:
+	static constexpr uint8_t INVALID = 0x80;
+
+	static constexpr std::array<uint8_t, 256> makeHexTable()
+	{
+		std::array<uint8_t, 256> table{};
+
+		for (size_t i = 0; i < table.size(); i++)
+		{
+			if (i >= '0' && i <= '9')
+				table[i] = static_cast<uint8_t>(i - '0');
+			else if (i >= 'a' && i <= 'f')
+				table[i] = static_cast<uint8_t>(i - 'a' + 10);
+			else if (i >= 'A' && i <= 'F')
+				table[i] = static_cast<uint8_t>(i - 'A' + 10);
+			else
+				table[i] = INVALID;
+		}
+
+		return table;
+	}
+
+	static constexpr std::array<uint8_t, 256> makeBase64Table()
+	{
+		std::array<uint8_t, 256> table{};
+
+		for (size_t i = 0; i < table.size(); i++)
+		{
+			if (i >= 'A' && i <= 'Z')
+				table[i] = static_cast<uint8_t>(i - 'A');
+			else if (i >= 'a' && i <= 'z')
+				table[i] = static_cast<uint8_t>(i - 'a' + 26);
+			else if (i >= '0' && i <= '9')
+				table[i] = static_cast<uint8_t>(i - '0' + 52);
+			else if (i == '+')
+				table[i] = 62;
+			else if (i == '/')
+				table[i] = 63;
+			else
+				table[i] = INVALID;
+		}
+
+		return table;
+	}
+
+public:
+	// Read-only view of decoded bytes, convertible to std::span if available
+	struct Blob
+	{
+		const std::byte* pData = nullptr;
+		size_t length          = 0;
+
+		const std::byte* data() const
+		{
+			return pData;
+		}
+
+		size_t size() const
+		{
+			return length;
+		}
+
+		const std::byte* begin() const
+		{
+			return pData;
+		}
+
+		const std::byte* end() const
+		{
+			return pData + length;
+		}
+
+#ifdef __cpp_lib_span
+		operator std::span<const std::byte>() const
+		{
+			return std::span<const std::byte>(pData, length);
+		}
+#endif
+	};
+
+public:
+	// Decodes an even number of hex digits (upper or lower case), 16 digits at a time if SSE2 is available
+	static bool decodeHex(const std::string_view& str, std::vector<std::byte>& out)
+	{
+		static constexpr std::array<uint8_t, 256> HEX_TABLE = makeHexTable();
+
+		if (str.size() % 2 != 0)
+			return false;
+
+		out.resize(str.size() / 2);
+
+		const char* pIn = str.data();
+		std::byte* pOut = out.data();
+		size_t pos      = 0;
+
+#ifdef CLP_SSE2
+		const __m128i zero = _mm_setzero_si128();
+
+		for (; pos + 16 <= str.size(); pos += 16)
+		{
+			const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + pos));
+			const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+			const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+			const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+			if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF)
+				return false;
+
+			const __m128i nibbles = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+												 _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+			// Each 16 bit lane holds the high nibble in its low byte and the low nibble in its high byte
+			const __m128i bytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(nibbles, 8));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(pOut + pos / 2), _mm_packus_epi16(bytes, zero));
+		}
+#endif
+
+		for (; pos < str.size(); pos += 2)
+		{
+			const uint8_t high = HEX_TABLE[static_cast<uint8_t>(pIn[pos])];
+			const uint8_t low  = HEX_TABLE[static_cast<uint8_t>(pIn[pos + 1])];
+
+			if ((high | low) & INVALID)
+				return false;
+
+			pOut[pos / 2] = static_cast<std::byte>((high << 4) | low);
+		}
+
+		return true;
+	}
+
+	// Decodes standard base64 with optional padding, 4 characters at a time with a single validity check
+	static bool decodeBase64(const std::string_view& str, std::vector<std::byte>& out)
+	{
+		static constexpr std::array<uint8_t, 256> BASE64_TABLE = makeBase64Table();
+
+		size_t length = str.size();
+
+		while (length > 0 && str[length - 1] == '=' && str.size() - length < 2)
+			length--;
+
+		if (length % 4 == 1 || (length != str.size() && str.size() % 4 != 0))
+			return false;
+
+		out.resize(length / 4 * 3 + (length % 4 ? length % 4 - 1 : 0));
+
+		const uint8_t* pIn = reinterpret_cast<const uint8_t*>(str.data());
+		std::byte* pOut    = out.data();
+		size_t pos         = 0;
+
+		for (; pos + 4 <= length; pos += 4, pOut += 3)
+		{
+			const uint32_t a = BASE64_TABLE[pIn[pos]];
+			const uint32_t b = BASE64_TABLE[pIn[pos + 1]];
+			const uint32_t c = BASE64_TABLE[pIn[pos + 2]];
+			const uint32_t d = BASE64_TABLE[pIn[pos + 3]];
+
+			if ((a | b | c | d) & INVALID)
+				return false;
+
+			const uint32_t value = (a << 18) | (b << 12) | (c << 6) | d;
+			pOut[0]              = static_cast<std::byte>(value >> 16);
+			pOut[1]              = static_cast<std::byte>(value >> 8);
+			pOut[2]              = static_cast<std::byte>(value);
+		}
+
+		if (pos < length)
+		{
+			uint32_t value = 0;
+
+			for (size_t i = 0; i < 4; i++)
+			{
+				const uint8_t sextet = pos + i < length ? BASE64_TABLE[pIn[pos + i]] : 0;
+
+				if (sextet & INVALID)
+					return false;
+
+				value = (value << 6) | sextet;
+			}
+
+			for (size_t i = 0; i < length - pos - 1; i++)
+				pOut[i] = static_cast<std::byte>(value >> (16 - 8 * i));
+		}
+
+		return true;
+	}
+};
+
+// Option declared at compile time, see StaticHelp
+struct StaticOption
+{
+	const char* arg;
+	const char* argAlt;
+	const char* desc;
+	const char* defaultValue = "";
+	bool hasValue            = true;
+	bool required            = false;
+	bool separator           = false;
+	size_t argCount          = 1; // Number of tokens following the option, see CommandLineOption::setArgCount
+};
+
+class CommandLineOption
+{
+public:
+	enum class HasValue
+	{
+		Yes,
+		No
+	};
+
+	enum class Required
+	{
+		Yes,
+		No
+	};
+
+	enum class Separator
+	{
+		Yes,
+		No
+	};
+
+	// Origin of the current value, a source can only override values of lower sources
+	enum class Source
+	{
+		Default,
+		Config,
+		Profile,
+		CommandLine
+	};
+
+	enum class ValueType
+	{
+		String,
+		Integer,
+		Unsigned,
+		Floating,
+		Boolean,
+		Address,  // List of IP addresses
+		Endpoint, // List of host:port pairs
+		Network,  // List of networks in CIDR notation
+		Hex,      // Binary data, decoded while parsing
+		Base64    // Binary data, decoded while parsing
+	};
+
+	// Computes the default value, only called once the default value is actually required
+	using DefaultProvider = std::function<std::string()>;
+
+	// Returns false if the given value is not acceptable for the option
+	using Validator = std::function<bool(const std::string&)>;
+
+	// Memory used in bytes, split into the schema (names to index) and the parse result (values, caches)
+	struct MemoryUsage
+	{
+		size_t names        = 0;
+		size_t descriptions = 0;
+		size_t defaults     = 0;
+		size_t options      = 0; // Size of the option objects themselves
+		size_t index        = 0; // Lookup structures, profiles and subscriptions
+		size_t values       = 0;
+		size_t caches       = 0; // Expanded values, unescaped list fields, diagnostics, config layer and argument buffers
+
+		size_t schema() const
+		{
+			return names + descriptions + defaults + options + index;
+		}
+
+		size_t result() const
+		{
+			return values + caches;
+		}
+
+		size_t total() const
+		{
+			return schema() + result();
+		}
+
+		MemoryUsage& operator+=(const MemoryUsage& rhs)
+		{
+			names += rhs.names;
+			descriptions += rhs.descriptions;
+			defaults += rhs.defaults;
+			options += rhs.options;
+			index += rhs.index;
+			values += rhs.values;
+			caches += rhs.caches;
+			return *this;
+		}
+	};
+
+public:
+	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc,
+					  const std::string& defaultValue, const HasValue& hasValue, const Required& required, const Separator& separator) :
+		m_arg(arg),
+		m_argAlt(argAlt),
+		m_desc(desc),
+		m_default(defaultValue),
+		m_required(required == Required::Yes),
+		m_hasValue(hasValue == HasValue::Yes),
+		m_isSeparator(separator == Separator::Yes)
+	{
+		// Only the first word of the alternative argument is matched, the rest is considered a description
+		const size_t begin = m_argAlt.find_first_not_of(" \t\n\v\f\r");
+		if (begin != std::string::npos)
+			m_argAltName = m_argAlt.substr(begin, m_argAlt.find_first_of(" \t\n\v\f\r", begin) - begin);
+	}
+
+	CommandLineOption(const char* pArg, const char* pArgAlt, const char* pDesc, const char* pDefaultValue,
+					  const HasValue& hasValue, const Required& required, const Separator& separator) :
+		CommandLineOption(std::string(pArg), std::string(pArgAlt), std::string(pDesc), std::string(pDefaultValue), hasValue, required, separator)
+	{
+	}
+
+	explicit CommandLineOption(const StaticOption& opt) :
+		CommandLineOption(opt.arg, opt.argAlt, opt.desc, opt.defaultValue, opt.hasValue ? HasValue::Yes : HasValue::No,
+						  opt.required ? Required::Yes : Required::No, opt.separator ? Separator::Yes : Separator::No)
+	{
+		if (opt.hasValue)
+			setArgCount(opt.argCount);
+	}
+
+	// If a default value is set, the option has to have a value
+	// When calling the constructor with a plain char* as default parameter, e.g., "DEFAULT"
+	// not the std::string constructor would be used, but the one for hasValue, because converting
+	// from char* to bool is a standard conversion, while char* to std::string is a user-defined conversion
+	// See: https://stackoverflow.com/a/26414524
+	// Therefore, a char* based constructor is available.
+	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const char* pDefault, const Required& required = Required::No) :
+		CommandLineOption(arg, argAlt, desc, std::string(pDefault), required)
+	{
+	}
+
+	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const std::string& defaultValue, const Required& required = Required::No) :
+		CommandLineOption(arg, argAlt, desc, defaultValue, HasValue::Yes, required, Separator::No)
+	{
+	}
+
+	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const HasValue& hasValue = HasValue::Yes, const Required& required = Required::No) :
+		CommandLineOption(arg, argAlt, desc, "", hasValue, required, Separator::No)
+	{
+	}
+
+	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const DefaultProvider& defaultProvider, const Required& required = Required::No) :
+		CommandLineOption(arg, argAlt, desc, "", HasValue::Yes, required, Separator::No)
+	{
+		setDefault(defaultProvider);
+	}
+
+	// Typed default value, stored natively and only formatted when required as string, e.g., for the help
+	template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+	CommandLineOption(const std::string& arg, const std::string& argAlt, const std::string& desc, const T& defaultValue, const Required& required = Required::No) :
+		CommandLineOption(arg, argAlt, desc, "", HasValue::Yes, required, Separator::No)
+	{
+		setDefault(defaultValue);
+	}
+
+	bool check(const std::string& arg)
+	{
+		// Do not expect the same option to be selected twice ...
+		// This is required to prevent set parameters from being
+		// overritten by following checks against different parameters
+		if (m_source == Source::CommandLine || !matches(arg))
+			return false;
+
+		m_set     = true;
+		m_source  = Source::CommandLine;
+		m_decoded = false;
+
+		return true;
+	}
+
+	bool matches(const std::string& arg) const
+	{
+		if (!m_arg.empty() && m_arg == arg)
+			return true;
+
+		return !m_argAltName.empty() && m_argAltName == arg;
+	}
+
+	void reset()
+	{
+		m_set    = false;
+		m_source = Source::Default;
+		m_value.clear();
+		m_blob.clear();
+		m_fieldEnds.clear();
+		m_decoded = false;
+	}
+
+	// Only true if the option was actually given, see hasDefault
+	bool isSet() const
+	{
+		return m_set;
+	}
+
+	// Does not evaluate a lazy default value, which is assumed to be non-empty
+	bool hasDefault() const
+	{
+		return m_pLazyDefault || !m_default.empty();
+	}
+
+	// Values of Hex, Base64 and network options are decoded right away, see decode
+	void setValue(const std::string& value)
+	{
+		m_value   = value;
+		m_decoded = false;
+		m_fieldEnds.clear();
+		decode();
+	}
+
+	// Sets the value of an option with multiple arguments from its separate tokens. The value holds
+	// the tokens separated by spaces, but the end of each token is kept, so tokens may contain spaces.
+	void setValues(char* const* ppTokens, const size_t& count)
+	{
+		m_value.clear();
+		m_fieldEnds.clear();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			m_value.append(i ? " " : "").append(ppTokens[i]);
+
+			if (count > 1)
+				m_fieldEnds.push_back(m_value.size());
+		}
+
+		m_decoded = false;
+		decode();
+	}
+
+	// End offsets of the tokens of a value set by setValues, empty for all other values
+	const std::vector<size_t>& getFieldEnds() const
+	{
+		return m_fieldEnds;
+	}
+
+	// Sets the value on behalf of the given source, unless a higher source already set it or force is given
+	bool setValue(const std::string& value, const Source& source, const bool& force = false)
+	{
+		if (!force && m_set && source < m_source)
+			return false;
+
+		m_value   = value;
+		m_source  = source;
+		m_set     = true;
+		m_decoded = false;
+		m_fieldEnds.clear();
+		decode();
+
+		return true;
+	}
+
+	Source getSource() const
+	{
+		return m_source;
+	}
+
+	const std::string& getValue() const
+	{
+		if (m_set)
+			return m_value;
+		else
+			return getDefault();
+	}
+
+	bool isRequired() const
+	{
+		return m_required;
+	}
+
+	void setRequired(const bool& required)
+	{
+		m_required = required;
+	}
+
+	bool hasValue() const
+	{
+		return m_hasValue;
+	}
+
+	// Options with multiple arguments consume that many tokens, e.g., "--resize 1920 1080",
+	// the value holds the tokens separated by spaces and is read via getValueAs<std::array<T, N>>
+	// or getValueAs<std::tuple<...>>. The boundaries of the tokens are kept, see setValues, while
+	// values given as a single string, e.g., in config files or profiles, are split at spaces.
+	void setArgCount(const size_t& count)
+	{
+		m_argCount = std::max<size_t>(count, 1);
+		m_hasValue = true;
+	}
+
+	size_t getArgCount() const
+	{
+		return m_hasValue ? m_argCount : 0;
+	}
+
+	// Number of arguments required to read the value as T, i.e., the size of std::array and std::tuple
+	template<typename T>
+	static constexpr size_t argCountOf()
+	{
+		if constexpr (IsTuple<T>::value)
+			return std::tuple_size<T>::value;
+		else
+			return 1;
+	}
+
+	void setSpaceAdd(const size_t& spaceAdd)
+	{
+		m_addSpace = spaceAdd;
+	}
+
+	const std::string& getArg() const
+	{
+		return m_arg;
+	}
+
+	const std::string& getArgAlt() const
+	{
+		return m_argAlt;
+	}
+
+	const std::string& getArgAltName() const
+	{
+		return m_argAltName;
+	}
+
+	void setDefault(const std::string& defaultValue)
+	{
+		m_default = defaultValue;
+		m_pLazyDefault.reset();
+		m_typedDefaultSet = false;
+		m_decoded         = false;
+	}
+
+	void setDefault(const DefaultProvider& defaultProvider)
+	{
+		m_default.clear();
+		m_typedDefaultSet = false;
+		m_decoded         = false;
+		m_pLazyDefault    = std::make_shared<LazyDefault>();
+		m_pLazyDefault->provider = defaultProvider;
+	}
+
+	template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+	void setDefault(const T& defaultValue)
+	{
+		m_type = typeOf<T>();
+
+		if (m_type == ValueType::Integer)
+			m_typedDefault.i = static_cast<int64_t>(defaultValue);
+		else if (m_type == ValueType::Unsigned)
+			m_typedDefault.u = static_cast<uint64_t>(defaultValue);
+		else if (m_type == ValueType::Floating)
+			m_typedDefault.d = static_cast<double>(defaultValue);
+		else
+			m_typedDefault.b = static_cast<bool>(defaultValue);
+
+		const ValueType type        = m_type;
+		const TypedValue typedValue = m_typedDefault;
+		setDefault([type, typedValue]() { return formatValue(type, typedValue); });
+		m_typedDefaultSet = true;
+	}
+
+	ValueType getType() const
+	{
+		return m_type;
+	}
+
+	void setValidator(const Validator& validator)
+	{
+		m_validator = validator;
+	}
+
+	bool validate(const std::string& value) const
+	{
+		return !m_validator || m_validator(value);
+	}
+
+	// Checks whether the value can be converted to the type of the option, for multiple arguments
+	// the number of fields and each field is checked, see FieldReader for the field ends
+	bool hasValidType(const std::string& value, const std::vector<size_t>* pFieldEnds = nullptr) const
+	{
+		if (m_argCount > 1)
+		{
+			FieldReader reader(value, pFieldEnds);
+			std::string_view field;
+			size_t count = 0;
+
+			for (; reader.next(field); count++)
+			{
+				if (!hasValidType(field))
+					return false;
+			}
+
+			return count == m_argCount;
+		}
+
+		return hasValidType(std::string_view(value));
+	}
+
+	bool hasValidType(const std::string_view& value) const
+	{
+		int64_t i;
+		uint64_t u;
+		double d;
+		bool b;
+
+		switch (m_type)
+		{
+			case ValueType::Integer:
+				return convertValue(value, i);
+			case ValueType::Unsigned:
+				return convertValue(value, u);
+			case ValueType::Floating:
+				return convertValue(value, d);
+			case ValueType::Boolean:
+				return convertValue(value, b);
+			case ValueType::Address:
+				return CommandLineNetwork::parseList<CommandLineNetwork::Address>(value).errors.empty();
+			case ValueType::Endpoint:
+				return CommandLineNetwork::parseList<CommandLineNetwork::Endpoint>(value).errors.empty();
+			case ValueType::Network:
+				return CommandLineNetwork::parseList<CommandLineNetwork::Network>(value).errors.empty();
+			case ValueType::Hex:
+			case ValueType::Base64:
+			{
+				std::vector<std::byte> blob;
+				return m_type == ValueType::Hex ? CommandLineEncoding::decodeHex(value, blob) : CommandLineEncoding::decodeBase64(value, blob);
+			}
+			default:
+				return true;
+		}
+	}
+
+	static const char* getTypeName(const ValueType& type)
+	{
+		switch (type)
+		{
+			case ValueType::Integer:
+				return "integer";
+			case ValueType::Unsigned:
+				return "unsigned integer";
+			case ValueType::Floating:
+				return "floating point number";
+			case ValueType::Boolean:
+				return "boolean";
+			case ValueType::Address:
+				return "list of IP addresses";
+			case ValueType::Endpoint:
+				return "list of endpoints (host:port)";
+			case ValueType::Network:
+				return "list of networks (address/prefix)";
+			case ValueType::Hex:
+				return "hex encoded data";
+			case ValueType::Base64:
+				return "base64 encoded data";
+			default:
+				return "string";
+		}
+	}
+
+	void setType(const ValueType& type)
+	{
+		m_type    = type;
+		m_decoded = false;
+	}
+
+	bool isBlob() const
+	{
+		return m_type == ValueType::Hex || m_type == ValueType::Base64;
+	}
+
+	bool isNetwork() const
+	{
+		return m_type == ValueType::Address || m_type == ValueType::Endpoint || m_type == ValueType::Network;
+	}
+
+	// Decodes the current value of a Hex or Base64 option or parses the list (',' separated) of a
+	// network option, returns false if it is not valid. The result is kept until the value changes.
+	bool decode()
+	{
+		if (!m_decoded)
+		{
+			m_decodedValid = decodeValue();
+			m_decoded      = true;
+		}
+
+		return m_decodedValid;
+	}
+
+	// Bytes of the last decoded value, see decode
+	CommandLineEncoding::Blob getBlob() const
+	{
+		return { m_blob.data(), m_blob.size() };
+	}
+
+	// The list parsed by decode, nullptr if the value was not decoded since it changed or T does not match the type
+	template<typename T>
+	const CommandLineNetwork::List<T>* getList() const
+	{
+		if (!m_decoded || !m_lists.pList)
+			return nullptr;
+
+		return std::get_if<CommandLineNetwork::List<T>>(m_lists.pList.get());
+	}
+
+	// Returns the next space separated field and removes it from str, empty if there is none
+	static std::string_view nextField(std::string_view& str)
+	{
+		const size_t begin = (std::min)(str.find_first_not_of(' '), str.size());
+		const size_t end   = (std::min)(str.find(' ', begin), str.size());
+		const std::string_view field = str.substr(begin, end - begin);
+
+		str.remove_prefix(end);
+		return field;
+	}
+
+	// Returns the value converted to T, a typed default value is returned without any conversion.
+	// If the value cannot be converted, a value initialized T is returned.
+	template<typename T>
+	T getValueAs() const
+	{
+		T value = T();
+
+		if constexpr (IsTuple<T>::value)
+		{
+			convertValue(getValue(), m_fieldEnds, value);
+			return value;
+		}
+		else if (!m_set && m_typedDefaultSet)
+		{
+			if constexpr (std::is_same<T, std::string>::value)
+				return getDefault();
+			else if constexpr (std::is_same<T, bool>::value)
+				return m_type == ValueType::Boolean ? m_typedDefault.b : m_typedDefault.i != 0;
+			else if (m_type == ValueType::Integer)
+				return static_cast<T>(m_typedDefault.i);
+			else if (m_type == ValueType::Unsigned)
+				return static_cast<T>(m_typedDefault.u);
+			else if (m_type == ValueType::Floating)
+				return static_cast<T>(m_typedDefault.d);
+			else
+				return static_cast<T>(m_typedDefault.b);
+		}
+
+		convertValue(getValue(), value);
+
+		return value;
+	}
+
+	template<typename T>
+	static bool convertValue(const std::string_view& str, T& value)
+	{
+		if constexpr (std::is_same<T, std::string>::value)
+		{
+			value = std::string(str);
+			return true;
+		}
+		else if constexpr (std::is_same<T, bool>::value)
+		{
+			if (str == "1" || str == "true" || str == "yes" || str == "on")
+				value = true;
+			else if (str == "0" || str == "false" || str == "no" || str == "off")
+				value = false;
+			else
+				return false;
+
+			return true;
+		}
+		else if constexpr (IsTuple<T>::value)
+		{
+			FieldReader reader(str);
+			return convertFields(reader, value, std::make_index_sequence<std::tuple_size<T>::value>());
+		}
+		else
+		{
+			static_assert(std::is_arithmetic<T>::value, "Unsupported value type");
+
+			const char* pEnd = str.data() + str.size();
+			const std::from_chars_result res = std::from_chars(str.data(), pEnd, value);
+			return res.ec == std::errc() && res.ptr == pEnd;
+		}
+	}
+
+	// Same as above, for values set from separate tokens, see setValues
+	template<typename T>
+	static bool convertValue(const std::string_view& str, const std::vector<size_t>& fieldEnds, T& value)
+	{
+		if constexpr (IsTuple<T>::value)
+		{
+			FieldReader reader(str, &fieldEnds);
+			return convertFields(reader, value, std::make_index_sequence<std::tuple_size<T>::value>());
+		}
+		else
+			return convertValue(str, value);
+	}
+
+	const std::string& getDefault() const
+	{
+		if (!m_pLazyDefault)
+			return m_default;
+
+		// Evaluated at most once, the result is shared between all copies of this option
+		LazyDefault& lazy = *m_pLazyDefault;
+		std::call_once(lazy.once, [&lazy]() { lazy.value = lazy.provider(); });
+
+		return lazy.value;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const CommandLineOption& clo)
+	{
+		// Windows cmd default width is 80
+		const size_t maxLineLen = 80;
+
+		const size_t spaceArgDesc = 4;
+
+		if (clo.m_isSeparator)
+			os << std::endl;
+		else
+		{
+			std::string argStr(clo.m_arg + ", " + clo.m_argAlt);
+			os << std::left << std::setfill(' ') << std::setw(clo.m_addSpace) << argStr;
+			os << std::setfill(' ') << std::setw(spaceArgDesc) << "";
+
+			std::string desc = clo.m_desc;
+
+			if (clo.m_required)
+				desc.append(" (required)");
+
+			if (clo.hasDefault() && !clo.getDefault().empty())
+			{
+				desc.append(" DEFAULT: ");
+				desc.append(clo.getDefault());
+			}
+
+			// In case the arguments are too long, the description exceeds the line but keeps a minimum width
+			const size_t minDescLen = 20;
+			const size_t indent     = spaceArgDesc + clo.m_addSpace;
+			const size_t width      = indent + minDescLen < maxLineLen ? maxLineLen - indent : minDescLen;
+			size_t pos              = 0;
+
+			while (desc.length() - pos > width)
+			{
+				// Break at the last space fitting into the line, words longer than a line are split.
+				// Only the current line is searched, otherwise long words would be searched up to the start.
+				size_t spacePos = std::string_view(desc).substr(pos, width + 1).find_last_of(' ');
+				size_t next     = pos + spacePos + 1;
+
+				if (spacePos == std::string_view::npos || spacePos == 0)
+				{
+					spacePos = width;
+					next     = pos + width;
+				}
+
+				spacePos += pos;
+
+				os.write(desc.data() + pos, static_cast<std::streamsize>(spacePos - pos)) << std::endl;
+				os << std::setfill(' ') << std::setw(indent) << "";
+				pos = next;
+			}
+
+			os.write(desc.data() + pos, static_cast<std::streamsize>(desc.length() - pos)) << std::endl;
+		}
+
+		return os;
+	}
+
+	bool operator==(const CommandLineOption& rhs) const
+	{
+		if (this == &rhs)
+			return true;
+
+		if (m_arg != rhs.m_arg || m_argAlt != rhs.m_argAlt)
+			return false;
+
+		// Compare the hashes in case a description was moved out, see releaseDescription
+		if (m_descReleased || rhs.m_descReleased)
+			return getDescriptionHash() == rhs.getDescriptionHash();
+
+		return m_desc == rhs.m_desc;
+	}
+
+	const std::string& getDescription() const
+	{
+		return m_desc;
+	}
+
+	void setDescription(const std::string& desc)
+	{
+		m_desc         = desc;
+		m_descReleased = false;
+	}
+
+	// Moves the description out of the option and frees its memory, the option is still
+	// considered equal to options with the original description
+	std::string releaseDescription()
+	{
+		std::string desc;
+
+		m_descHash     = getDescriptionHash();
+		m_descReleased = true;
+		desc.swap(m_desc);
+
+		return desc;
+	}
+
+	bool isDescriptionReleased() const
+	{
+		return m_descReleased;
+	}
+
+	uint64_t getDescriptionHash() const
+	{
+		return m_descReleased ? m_descHash : CommandLineHash::fnv1a(m_desc);
+	}
+
+	// Lazy default values are shared between copies, but accounted to each of them
+	MemoryUsage getMemoryUsage() const
+	{
+		MemoryUsage usage;
+
+		usage.names        = heapSize(m_arg) + heapSize(m_argAlt) + heapSize(m_argAltName);
+		usage.descriptions = heapSize(m_desc);
+		usage.defaults     = heapSize(m_default);
+		usage.options      = sizeof(CommandLineOption);
+		usage.values       = heapSize(m_value) + m_blob.capacity() + m_lists.capacity() + m_fieldEnds.capacity() * sizeof(size_t);
+
+		if (m_pLazyDefault)
+			usage.defaults += sizeof(LazyDefault) + heapSize(m_pLazyDefault->value);
+
+		return usage;
+	}
+
+	// Heap memory used by the string, strings using the small string optimization use none
+	static size_t heapSize(const std::string& str)
+	{
+		return str.capacity() > std::string().capacity() ? str.capacity() + 1 : 0;
+	}
+
+	size_t getArgsLength() const
+	{
+		if (m_isSeparator) return 0;
+
+		return m_arg.size() + 2 + m_argAlt.size();
+	}
+
+private:
+	// Fields of a value with multiple arguments, given by the end offset of each field, see setValues,
+	// or, without field ends, separated by spaces
+	class FieldReader
+	{
+	public:
+		explicit FieldReader(const std::string_view& value, const std::vector<size_t>* pFieldEnds = nullptr) :
+			m_value(value),
+			m_pFieldEnds(pFieldEnds != nullptr && !pFieldEnds->empty() ? pFieldEnds : nullptr)
+		{
+		}
+
+		// Returns false if there are no more fields, fields given by their ends may be empty
+		bool next(std::string_view& field)
+		{
+			if (m_pFieldEnds == nullptr)
+			{
+				field = nextField(m_value);
+				return !field.empty();
+			}
+
+			if (m_idx == m_pFieldEnds->size() || (*m_pFieldEnds)[m_idx] > m_value.size())
+				return false;
+
+			const size_t begin = m_idx ? (*m_pFieldEnds)[m_idx - 1] + 1 : 0;
+			field              = m_value.substr(begin, (*m_pFieldEnds)[m_idx++] - begin);
+
+			return true;
+		}
+
+	private:
+		std::string_view m_value;
+		const std::vector<size_t>* m_pFieldEnds;
+		size_t m_idx = 0;
+	};
+
+	template<typename T>
+	struct IsTuple : std::false_type
+	{
+	};
+
+	template<typename... T>
+	struct IsTuple<std::tuple<T...>> : std::true_type
+	{
+	};
+
+	template<typename T, size_t N>
+	struct IsTuple<std::array<T, N>> : std::true_type
+	{
+	};
+
+	// Converts the fields in place into the elements of the tuple or array
+	template<typename T, size_t... I>
+	static bool convertFields(FieldReader& reader, T& value, std::index_sequence<I...>)
+	{
+		std::string_view field;
+		bool valid = true;
+		((valid = valid && reader.next(field) && convertValue(field, std::get<I>(value))), ...);
+
+		return valid && !reader.next(field);
+	}
+
+	union TypedValue
+	{
+		int64_t i;
+		uint64_t u;
+		double d;
+		bool b;
+	};
+
+	struct LazyDefault
+	{
+		DefaultProvider provider;
+		std::once_flag once;
+		std::string value;
+	};
+
+	// The host names of endpoints refer to the value of the option, therefore copies (and moves,
+	// which fall back to copies) start without a list and have to be decoded again. The list is
+	// only allocated when a network option is decoded, so other options pay for a pointer only.
+	struct NetworkLists
+	{
+		using List = std::variant<CommandLineNetwork::List<CommandLineNetwork::Address>, CommandLineNetwork::List<CommandLineNetwork::Endpoint>,
+								  CommandLineNetwork::List<CommandLineNetwork::Network>>;
+
+		NetworkLists() = default;
+
+		NetworkLists(const NetworkLists&)
+		{
+		}
+
+		NetworkLists& operator=(const NetworkLists&)
+		{
+			pList.reset();
+			return *this;
+		}
+
+		size_t capacity() const
+		{
+			if (!pList)
+				return 0;
+
+			return sizeof(List) + std::visit([](const auto& list) {
+					   return list.items.capacity() * sizeof(typename decltype(list.items)::value_type) + list.errors.capacity() * sizeof(CommandLineNetwork::Error);
+				   }, *pList);
+		}
+
+		std::unique_ptr<List> pList;
+	};
+
+	bool decodeValue()
+	{
+		switch (m_type)
+		{
+			case ValueType::Hex:
+				return CommandLineEncoding::decodeHex(getValue(), m_blob);
+			case ValueType::Base64:
+				return CommandLineEncoding::decodeBase64(getValue(), m_blob);
+			case ValueType::Address:
+				return decodeList<CommandLineNetwork::Address>();
+			case ValueType::Endpoint:
+				return decodeList<CommandLineNetwork::Endpoint>();
+			case ValueType::Network:
+				return decodeList<CommandLineNetwork::Network>();
+			default:
+				return true;
+		}
+	}
+
+	template<typename T>
+	bool decodeList()
+	{
+		if (!m_lists.pList)
+			m_lists.pList.reset(new NetworkLists::List());
+
+		*m_lists.pList = CommandLineNetwork::parseList<T>(getValue());
+
+		return std::get<CommandLineNetwork::List<T>>(*m_lists.pList).errors.empty();
+	}
+
+	template<typename T>
+	static constexpr ValueType typeOf()
+	{
+		if (std::is_same<T, bool>::value)
+			return ValueType::Boolean;
+		else if (std::is_floating_point<T>::value)
+			return ValueType::Floating;
+		else if (std::is_signed<T>::value)
+			return ValueType::Integer;
+		else
+			return ValueType::Unsigned;
+	}
+
+	static std::string formatValue(const ValueType& type, const TypedValue& value)
+	{
+		if (type == ValueType::Boolean)
+			return value.b ? "true" : "false";
+
+		char buffer[32];
+		std::to_chars_result res;
+
+		if (type == ValueType::Integer)
+			res = std::to_chars(buffer, buffer + sizeof(buffer), value.i);
+		else if (type == ValueType::Unsigned)
+			res = std::to_chars(buffer, buffer + sizeof(buffer), value.u);
+		else
+			res = std::to_chars(buffer, buffer + sizeof(buffer), value.d);
+
+		return std::string(buffer, res.ptr);
+	}
+
+private:
+	std::string m_arg;
+	std::string m_argAlt;
+	std::string m_argAltName;
+	std::string m_desc;
+	std::string m_value = "";
+	std::vector<size_t> m_fieldEnds;
+	std::string m_default;
+	std::vector<std::byte> m_blob;
+	NetworkLists m_lists;
+	bool m_decoded      = false;
+	bool m_decodedValid = true;
+	std::shared_ptr<LazyDefault> m_pLazyDefault;
+	Validator m_validator;
+	TypedValue m_typedDefault = {};
+	bool m_typedDefaultSet = false;
+	ValueType m_type = ValueType::String;
+	bool m_set = false;
+	Source m_source = Source::Default;
+	bool m_required;
+	bool m_hasValue;
+	size_t m_argCount = 1;
+	bool m_isSeparator;
+	size_t m_addSpace = 0;
+	uint64_t m_descHash = 0;
+	bool m_descReleased = false;
+};
+
+using CLO = CommandLineOption;
+
+class CommandLineWorkers
+{
+public:
+	// Calls func(worker, index) for all indices in [0, count) distributed over the given number
+	// of threads (0 = hardware concurrency), each worker can keep its own state based on its id
+	static void forEach(const size_t& count, size_t threads, const std::function<void(const size_t&, const size_t&)>& func)
+	{
+		if (threads == 0)
+			threads = (std::max)(1u, std::thread::hardware_concurrency());
+
+		threads = (std::min)(threads, count);
+
+		std::atomic<size_t> next(0);
+		std::vector<std::thread> workers;
+
+		auto worker = [&](const size_t& id) {
+			for (size_t idx = next++; idx < count; idx = next++)
+				func(id, idx);
+		};
+
+		for (size_t i = 1; i < threads; i++)
+			workers.emplace_back(worker, i);
+
+		worker(0);
+
+		for (std::thread& t : workers)
+			t.join();
+	}
+
+	static size_t count(const size_t& items, const size_t& threads)
+	{
+		const size_t maxThreads = threads == 0 ? (std::max)(1u, std::thread::hardware_concurrency()) : threads;
+		return (std::max)(static_cast<size_t>(1), (std::min)(maxThreads, items));
+	}
+};
+
+class CommandLineFiles
+{
+public:
+	// Writes the file via write(stream) to a temporary file next to it, which then replaces the
+	// file, so concurrent readers never see a partial file. The temporary name is unique per
+	// process and thread, as, e.g., forked workers share the ids of their threads.
+	static bool replace(const std::string& path, const std::function<void(std::ostream&)>& write)
+	{
+#ifdef _WIN32
+		const unsigned long pid = GetCurrentProcessId();
+#else
+		const long pid = static_cast<long>(getpid());
+#endif
+		const std::string tmpPath = path + "." + std::to_string(pid) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+		{
+			std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+			write(file);
+
+			if (!file)
+			{
+				file.close();
+				std::remove(tmpPath.c_str());
+				return false;
+			}
+		}
+
+		if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+		{
+			std::remove(tmpPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+};
+
+// Config files consist of "key = value" lines, where the key is the name of an option without
+// leading dashes. Lines starting with '#' or ';' are comments, "include = file" includes another
+// file, relative to the directory of the including file.
+// Tokenized files are cached keyed by path, inode, modification time and size, in-process and,
+// optionally, in a cache directory shared by multiple processes. The directory holds one file
+// per config path, which is replaced when the config changes, i.e., it does not grow with edits.
+class ConfigFile
+{
+public:
+	using Entries = std::vector<std::pair<std::string, std::string>>;
+
+	struct Fragment
+	{
+		std::string path;
+		Entries entries;
+	};
+
+	using FragmentPtr = std::shared_ptr<const Fragment>;
+
+public:
+	// Enables the on-disk cache, an empty directory disables it
+	static void setCacheDirectory(const std::string& directory)
+	{
+		std::lock_guard<std::mutex> lock(cache().mutex);
+		cache().directory = directory;
+	}
+
+	// Returns the tokenized file, without resolving includes, or nullptr if the file cannot be read
+	static FragmentPtr load(const std::string& path)
+	{
+		struct stat st;
+
+		if (stat(path.c_str(), &st) != 0)
+			return nullptr;
+
+		uint64_t key = CommandLineHash::fnv1a(path);
+		key          = CommandLineHash::fnv1a(static_cast<uint64_t>(st.st_ino), key);
+		key          = CommandLineHash::fnv1a(modificationTime(st), key);
+		key          = CommandLineHash::fnv1a(static_cast<uint64_t>(st.st_size), key);
+
+		Cache& c = cache();
+		std::string directory;
+
+		{
+			std::lock_guard<std::mutex> lock(c.mutex);
+			std::unordered_map<std::string, std::pair<uint64_t, FragmentPtr>>::const_iterator it = c.fragments.find(path);
+
+			if (it != c.fragments.end() && it->second.first == key)
+				return it->second.second;
+
+			directory = c.directory;
+		}
+
+		FragmentPtr pFragment = directory.empty() ? nullptr : readCache(cacheFile(directory, path), path, key);
+
+		if (!pFragment)
+		{
+			std::ifstream file(path);
+
+			if (!file)
+				return nullptr;
+
+			pFragment = tokenize(path, file);
+
+			if (!directory.empty())
+				writeCache(cacheFile(directory, path), *pFragment, key);
+		}
+
+		// Only the latest version of each file is kept
+		std::lock_guard<std::mutex> lock(c.mutex);
+		c.fragments[path] = { key, pFragment };
+
+		return pFragment;
+	}
+
+	// Appends the entries of the file with all includes expanded in place, errors, e.g.,
+	// unreadable files or include cycles, are appended to errors
+	static bool flatten(const std::string& path, Entries& entries, std::vector<std::string>& errors)
+	{
+		std::vector<std::string> stack;
+		return flatten(path, entries, errors, stack);
+	}
+
+	static FragmentPtr tokenize(const std::string& path, std::istream& stream)
+	{
+		std::shared_ptr<Fragment> pFragment = std::make_shared<Fragment>();
+		std::string line;
+
+		pFragment->path = path;
+
+		while (std::getline(stream, line))
+		{
+			const std::string_view str = trim(line);
+
+			if (str.empty() || str.front() == '#' || str.front() == ';')
+				continue;
+
+			const size_t pos = str.find('=');
+
+			if (pos == std::string_view::npos)
+			{
+				pFragment->entries.push_back({ std::string(str), "" });
+				continue;
+			}
+
+			std::string_view value = trim(str.substr(pos + 1));
+
+			if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+				value = value.substr(1, value.size() - 2);
+
+			pFragment->entries.push_back({ std::string(trim(str.substr(0, pos))), std::string(value) });
+		}
+
+		return pFragment;
+	}
+
+private:
+	struct Cache
+	{
+		std::mutex mutex;
+		std::unordered_map<std::string, std::pair<uint64_t, FragmentPtr>> fragments; // Version key and content per path
+		std::string directory;
+	};
+
+	static Cache& cache()
+	{
+		static Cache c;
+		return c;
+	}
+
+	static bool flatten(const std::string& path, Entries& entries, std::vector<std::string>& errors, std::vector<std::string>& stack)
+	{
+		const std::string canonical = canonicalPath(path);
+
+		if (std::find(stack.begin(), stack.end(), canonical) != stack.end())
+		{
+			errors.push_back("Include cycle detected at " + path);
+			return false;
+		}
+
+		FragmentPtr pFragment = load(path);
+
+		if (!pFragment)
+		{
+			errors.push_back("Unable to read config file " + path);
+			return false;
+		}
+
+		bool success = true;
+		stack.push_back(canonical);
+
+		for (const std::pair<std::string, std::string>& entry : pFragment->entries)
+		{
+			if (entry.first != "include")
+				entries.push_back(entry);
+			else
+				success &= flatten(resolvePath(path, entry.second), entries, errors, stack);
+		}
+
+		stack.pop_back();
+
+		return success;
+	}
+
+	static std::string_view trim(const std::string_view& str)
+	{
+		const size_t first = str.find_first_not_of(" \t\r");
+
+		if (first == std::string_view::npos)
+			return std::string_view();
+
+		return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+	}
+
+	static std::string resolvePath(const std::string& includingFile, const std::string& path)
+	{
+		if (path.empty() || path.front() == '/' || path.front() == '\\' || (path.size() > 1 && path[1] == ':'))
+			return path;
+
+		const size_t pos = includingFile.find_last_of("/\\");
+		return pos == std::string::npos ? path : includingFile.substr(0, pos + 1) + path;
+	}
+
+	static std::string canonicalPath(const std::string& path)
+	{
+#ifdef _WIN32
+		char buffer[_MAX_PATH];
+		return _fullpath(buffer, path.c_str(), _MAX_PATH) ? std::string(buffer) : path;
+#else
+		std::unique_ptr<char, decltype(&free)> pPath(realpath(path.c_str(), nullptr), &free);
+		return pPath ? std::string(pPath.get()) : path;
+#endif
+	}
+
+	static uint64_t modificationTime(const struct stat& st)
+	{
+#ifdef __linux__
+		return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+#else
+		return static_cast<uint64_t>(st.st_mtime);
+#endif
+	}
+
+	static std::string cacheFile(const std::string& directory, const std::string& path)
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "/%016llx.clpc", static_cast<unsigned long long>(CommandLineHash::fnv1a(path)));
+		return directory + name;
+	}
+
+	// Format: "CLPC2 <version key> <entries> <path length>\n<path>" followed by "<key length> <value length>\n<key><value>"
+	// per entry. The cache directory may be shared, so all sizes are checked against the file size
+	// and a damaged file, as well as one of another version of the config, is treated as a cache miss.
+	static FragmentPtr readCache(const std::string& cachePath, const std::string& path, const uint64_t& key)
+	{
+		std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+		const std::streamoff size = file.tellg();
+		std::string magic;
+		uint64_t fileKey = 0;
+		size_t count = 0, length = 0;
+
+		if (!file || !file.seekg(0))
+			return nullptr;
+
+		// Remaining bytes of the file, the minimum size of an entry is "0 0\n"
+		const auto remaining = [&file, &size]() { return static_cast<size_t>(size - file.tellg()); };
+
+		if (!(file >> magic >> fileKey >> count >> length) || magic != "CLPC2" || fileKey != key || file.get() != '\n' || length > remaining() || count > remaining() / 4)
+			return nullptr;
+
+		std::shared_ptr<Fragment> pFragment = std::make_shared<Fragment>();
+		pFragment->path.resize(length);
+
+		if (!file.read(&pFragment->path[0], length) || pFragment->path != path)
+			return nullptr;
+
+		pFragment->entries.resize(count);
+
+		for (std::pair<std::string, std::string>& entry : pFragment->entries)
+		{
+			size_t keyLength = 0, valueLength = 0;
+
+			if (!(file >> keyLength >> valueLength) || file.get() != '\n' || keyLength > remaining() || valueLength > remaining() - keyLength)
+				return nullptr;
+
+			entry.first.resize(keyLength);
+			entry.second.resize(valueLength);
+
+			if (!file.read(&entry.first[0], keyLength) || !file.read(&entry.second[0], valueLength))
+				return nullptr;
+		}
+
+		return pFragment;
+	}
+
+	static void writeCache(const std::string& cachePath, const Fragment& fragment, const uint64_t& key)
+	{
+		CommandLineFiles::replace(cachePath, [&fragment, &key](std::ostream& file) {
+			file << "CLPC2 " << key << " " << fragment.entries.size() << " " << fragment.path.size() << "\n"
+				 << fragment.path;
+
+			for (const std::pair<std::string, std::string>& entry : fragment.entries)
+				file << entry.first.size() << " " << entry.second.size() << "\n"
+					 << entry.first << entry.second;
+		});
+	}
+};
+
+// Immutable copy of the effective option values, e.g., to be shared between threads
+// after parsing, see CommandLineParser::getSnapshot
+class CommandLineSnapshot
+{
+public:
+	// The value is stored under all given names, e.g., "-t" and "--threads"
+	void add(const std::vector<std::string>& names, const std::string_view& value, const bool& set)
+	{
+		for (const std::string& name : names)
+			m_names.emplace(name, m_entries.size());
+
+		m_entries.push_back({ m_data.size(), value.size(), set });
+		m_data.append(value);
+	}
+
+	bool isSet(const std::string& name) const
+	{
+		const size_t idx = indexOf(name);
+		return idx != NOT_FOUND && m_entries[idx].set;
+	}
+
+	// The view refers to the snapshot and is valid as long as the snapshot exists
+	std::string_view getValue(const std::string& name) const
+	{
+		const size_t idx = indexOf(name);
+
+		if (idx == NOT_FOUND)
+			return std::string_view();
+
+		return std::string_view(m_data.data() + m_entries[idx].offset, m_entries[idx].length);
+	}
+
+	template<typename T>
+	T getValueAs(const std::string& name) const
+	{
+		T value = T();
+		CLO::convertValue(getValue(name), value);
+		return value;
+	}
+
+	size_t size() const
+	{
+		return m_entries.size();
+	}
+
+private:
+	static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+	struct Entry
+	{
+		size_t offset;
+		size_t length;
+		bool set;
+	};
+
+	size_t indexOf(const std::string& name) const
+	{
+		std::unordered_map<std::string, size_t>::const_iterator it = m_names.find(name);
+		return it == m_names.end() ? NOT_FOUND : it->second;
+	}
+
+private:
+	std::string m_data;
+	std::vector<Entry> m_entries;
+	std::unordered_map<std::string, size_t> m_names;
+};
+
+// Keeps one copy of a read-mostly object (e.g., a CommandLineSnapshot) per NUMA node, so threads
+// on all sockets read local memory. Each replica is created by a thread bound to the CPUs of its
+// node, i.e., the first-touch policy places its memory on that node. The nodes are read from
+// sysfs, without replication (Windows, non-Linux, single node) a single copy is kept.
+// See bench/replicas.cpp for the read latency of local and remote replicas.
+template<typename T>
+class CommandLineReplicas
+{
+public:
+	explicit CommandLineReplicas(const T& value, const bool& replicate = true) :
+		m_id(nextId())
+	{
+#ifdef __linux__
+		if (replicate)
+		{
+			for (const std::pair<size_t, size_t>& range : HostInfo::readRangeList("/sys/devices/system/node/online"))
+			{
+				for (size_t node = range.first; node <= range.second; node++)
+				{
+					const std::vector<std::pair<size_t, size_t>> cpus = HostInfo::readRangeList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+
+					// Nodes without CPUs (e.g., memory only nodes) are never local to a thread
+					if (cpus.empty())
+						continue;
+
+					for (const std::pair<size_t, size_t>& cpu : cpus)
+					{
+						if (m_cpuToReplica.size() <= cpu.second)
+							m_cpuToReplica.resize(cpu.second + 1, 0);
+
+						std::fill(m_cpuToReplica.begin() + static_cast<std::ptrdiff_t>(cpu.first), m_cpuToReplica.begin() + static_cast<std::ptrdiff_t>(cpu.second) + 1, m_nodeCpus.size());
+					}
+
+					m_nodeCpus.push_back(cpus);
+				}
+			}
+		}
+#else
+		(void)replicate;
+#endif
+
+		m_replicas = std::vector<std::shared_ptr<const T>>((std::max)(static_cast<size_t>(1), m_nodeCpus.size()));
+		update(value);
+	}
+
+	// Replaces all replicas, readers holding an old replica keep it alive until they release it
+	void update(const T& value)
+	{
+		if (m_nodeCpus.size() <= 1)
+		{
+			std::atomic_store(&m_replicas[0], std::make_shared<const T>(value));
+			m_version.fetch_add(1, std::memory_order_release);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+
+		for (size_t i = 0; i < m_nodeCpus.size(); i++)
+		{
+			threads.emplace_back([this, &value, i]()
+			{
+				bindToNode(i);
+				std::atomic_store(&m_replicas[i], std::make_shared<const T>(value));
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		m_version.fetch_add(1, std::memory_order_release);
+	}
+
+	// Replica of the node the calling thread currently runs on. Each thread keeps the replica it
+	// read last, so only the first read after an update or a migration to another node uses the
+	// atomic access of the shared pointer, which libstdc++ implements with a global lock. The kept
+	// replica stays alive until the thread reads another one or exits.
+	std::shared_ptr<const T> local() const
+	{
+		struct Cache
+		{
+			uint64_t id      = 0;
+			uint64_t version = 0;
+			size_t idx       = 0;
+			std::shared_ptr<const T> pReplica;
+		};
+
+		thread_local Cache cache;
+		const size_t idx       = localReplica();
+		const uint64_t version = m_version.load(std::memory_order_acquire);
+
+		if (cache.id != m_id || cache.version != version || cache.idx != idx || !cache.pReplica)
+		{
+			cache.pReplica = replica(idx);
+			cache.id       = m_id;
+			cache.version  = version;
+			cache.idx      = idx;
+		}
+
+		return cache.pReplica;
+	}
+
+	std::shared_ptr<const T> replica(const size_t& idx) const
+	{
+		return std::atomic_load(&m_replicas[idx]);
+	}
+
+	size_t count() const
+	{
+		return m_replicas.size();
+	}
+
+	size_t localReplica() const
+	{
+#ifdef __linux__
+		const int cpu = sched_getcpu();
+
+		if (cpu >= 0 && static_cast<size_t>(cpu) < m_cpuToReplica.size())
+			return m_cpuToReplica[cpu];
+#endif
+		return 0;
+	}
+
+private:
+	// Identifies the instance in the per-thread cache of local, unlike its address, which may be reused
+	static uint64_t nextId()
+	{
+		static std::atomic<uint64_t> next(1);
+		return next++;
+	}
+
+	void bindToNode(const size_t& idx) const
+	{
+#ifdef __linux__
+		if (idx >= m_nodeCpus.size())
+			return;
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+
+		for (const std::pair<size_t, size_t>& range : m_nodeCpus[idx])
+		{
+			for (size_t cpu = range.first; cpu <= range.second && cpu < CPU_SETSIZE; cpu++)
+				CPU_SET(cpu, &set);
+		}
+
+		sched_setaffinity(0, sizeof(set), &set);
+#else
+		(void)idx;
+#endif
+	}
+
+private:
+	const uint64_t m_id;
+	std::atomic<uint64_t> m_version{ 0 };
+	std::vector<std::shared_ptr<const T>> m_replicas;
+	std::vector<std::vector<std::pair<size_t, size_t>>> m_nodeCpus;
+	std::vector<size_t> m_cpuToReplica;
+};
+
+class CommandLineParser
+{
+	using CommandLineOptions = std::deque<CommandLineOption>;
+
+public:
+	enum class ProfilePrecedence
+	{
+		CommandLine, // Values given on the command line are kept
+		Profile      // Profile values override values given on the command line
+	};
+
+	using ProfileValues = std::vector<std::pair<CommandLineOption, std::string>>;
+
+	enum class ListFormat
+	{
+		Plain, // Fields are split at every delimiter
+		Csv    // Fields may be quoted as in RFC 4180, e.g., "a,b",c with "" for a quote
+	};
+
+	// Receives all options of interest whose effective value changed by one config (re)load
+	using ChangeCallback = std::function<void(const std::vector<const CommandLineOption*>&)>;
+
+	enum class DiagnosticKind
+	{
+		UnknownOption,
+		MissingValue,
+		BadType,
+		ValidationFailed,
+		MissingRequired,
+		RuleViolation
+	};
+
+	struct Diagnostic
+	{
+		DiagnosticKind kind;
+		int token;     // Index of the related argument, -1 if the problem is not related to an argument
+		size_t offset; // Byte offset in the command line (arguments separated by a single space)
+		size_t length; // Number of bytes the problem spans
+		std::string message;
+	};
+
+	// Values of a single parse via parseInto, which does not modify the parser, i.e., the parser
+	// serves as a schema shared by any number of results. Only the options set by the parsed
+	// arguments are stored, sorted by option index, all others fall back to the parser (config,
+	// profile or default value). Memory and clear are proportional to the number of set options
+	// and all buffers keep their capacity when the result is reused. Values are validated, but
+	// neither decoded (see CommandLineParser::getBlob) nor are profiles applied.
+	class Result
+	{
+	public:
+		Result() = default;
+
+		// The arguments of a parsed command line string refer to buffers of the result
+		Result(const Result&) = delete;
+		Result& operator=(const Result&) = delete;
+
+		void clear()
+		{
+			for (size_t i = 0; i < m_count; i++)
+			{
+				m_entries[i].value.clear();
+				m_entries[i].fieldEnds.clear();
+			}
+
+			if (m_count > 0)
+				std::fill(m_slots.begin(), m_slots.end(), 0);
+
+			m_count = 0;
+			m_unknown.clear();
+			m_diagnostics.clear();
+			m_offsetToken = 0;
+			m_offset      = 0;
+		}
+
+		bool isSet(const CommandLineOption& opt) const
+		{
+			const size_t idx = indexOf(opt);
+			return idx != NOT_FOUND && (find(idx) != nullptr || m_pParser->m_options[idx].isSet());
+		}
+
+		// The returned reference is valid until the result is cleared or reused
+		const std::string& getValue(const CommandLineOption& opt) const
+		{
+			static const std::string EMPTY;
+			const size_t idx = indexOf(opt);
+
+			if (idx == NOT_FOUND)
+				return EMPTY;
+
+			const std::string* pValue = find(idx);
+			return pValue ? *pValue : m_pParser->m_options[idx].getValue();
+		}
+
+		template<typename T>
+		T getValueAs(const CommandLineOption& opt) const
+		{
+			const size_t idx = indexOf(opt);
+			T value          = T();
+
+			if (idx == NOT_FOUND)
+				return value;
+
+			const Entry* pEntry = findEntry(idx);
+
+			if (pEntry == nullptr)
+				return m_pParser->m_options[idx].getValueAs<T>();
+
+			CLO::convertValue(pEntry->value, pEntry->fieldEnds, value);
+			return value;
+		}
+
+		// Number of options set by the parsed arguments
+		size_t size() const
+		{
+			return m_count;
+		}
+
+		CLO::MemoryUsage getMemoryUsage() const
+		{
+			CLO::MemoryUsage usage;
+			usage.options = sizeof(Result);
+			usage.values  = m_entries.capacity() * sizeof(Entry);
+			usage.caches  = m_unknown.capacity() * sizeof(int) + m_diagnostics.capacity() * sizeof(Diagnostic) + CLO::heapSize(m_key) + m_slots.capacity() * sizeof(size_t);
+
+			for (const Entry& entry : m_entries)
+				usage.values += CLO::heapSize(entry.value) + entry.fieldEnds.capacity() * sizeof(size_t);
+
+			for (const Diagnostic& diag : m_diagnostics)
+				usage.caches += CLO::heapSize(diag.message);
+
+			return usage;
+		}
+
+		const std::vector<Diagnostic>& getDiagnostics() const
+		{
+			return m_diagnostics;
+		}
+
+		// Indices of the arguments starting with '-' that did not match any option
+		const std::vector<int>& getUnknown() const
+		{
+			return m_unknown;
+		}
+
+		// Calls func(option, value) for all options set by the parsed arguments in registration order
+		template<typename Func>
+		void forEachSet(const Func& func) const
+		{
+			for (size_t i = 0; i < m_count; i++)
+				func(m_pParser->m_options[m_entries[i].idx], m_entries[i].value);
+		}
+
+	private:
+		friend class CommandLineParser;
+
+		struct Entry
+		{
+			size_t idx;
+			std::string value;
+			std::vector<size_t> fieldEnds; // See CommandLineOption::setValues
+		};
+
+		size_t indexOf(const CommandLineOption& opt) const
+		{
+			return m_pParser == nullptr ? NOT_FOUND : m_pParser->indexOf(opt);
+		}
+
+		const Entry* findEntry(const size_t& idx) const
+		{
+			const Entry* pEnd = m_entries.data() + m_count;
+			const Entry* pIt  = std::lower_bound(m_entries.data(), pEnd, idx, [](const Entry& entry, const size_t& i) { return entry.idx < i; });
+
+			return pIt != pEnd && pIt->idx == idx ? pIt : nullptr;
+		}
+
+		const std::string* find(const size_t& idx) const
+		{
+			const Entry* pEntry = findEntry(idx);
+			return pEntry ? &pEntry->value : nullptr;
+		}
+
+		// The options set by the current parse are kept in an open addressed set of option indices
+		// plus one (zero marks a free slot), which is at most half full, i.e., sized to the entries
+		size_t slotOf(const size_t& idx) const
+		{
+			const size_t mask = m_slots.size() - 1;
+			size_t slot       = static_cast<size_t>(idx * 0x9E3779B9u) & mask;
+
+			while (m_slots[slot] != 0 && m_slots[slot] != idx + 1)
+				slot = (slot + 1) & mask;
+
+			return slot;
+		}
+
+		// Returns true if the option was already set by the current parse
+		bool wasSet(const size_t& idx) const
+		{
+			return !m_slots.empty() && m_slots[slotOf(idx)] != 0;
+		}
+
+		// Must be called before add, i.e., while the set holds the m_count entries
+		void mark(const size_t& idx)
+		{
+			if ((m_count + 1) * 2 > m_slots.size())
+			{
+				m_slots.assign((std::max)(m_slots.size() * 2, static_cast<size_t>(8)), 0);
+
+				for (size_t i = 0; i < m_count; i++)
+					m_slots[slotOf(m_entries[i].idx)] = m_entries[i].idx + 1;
+			}
+
+			m_slots[slotOf(idx)] = idx + 1;
+		}
+
+		// Entries beyond the current count are kept to reuse their buffers
+		Entry& add(const size_t& idx)
+		{
+			if (m_count == m_entries.size())
+				m_entries.emplace_back();
+
+			Entry& entry = m_entries[m_count++];
+			entry.idx    = idx;
+			entry.value.clear();
+			entry.fieldEnds.clear();
+
+			return entry;
+		}
+
+		// Sorts the entries by option index, each option is added once, see mark
+		void finish()
+		{
+			std::sort(m_entries.begin(), m_entries.begin() + static_cast<std::ptrdiff_t>(m_count), [](const Entry& a, const Entry& b) { return a.idx < b.idx; });
+		}
+
+	private:
+		const CommandLineParser* m_pParser = nullptr;
+		std::vector<Entry> m_entries;
+		size_t m_count = 0;
+		std::vector<size_t> m_slots; // See slotOf
+		std::vector<int> m_unknown;
+		std::vector<Diagnostic> m_diagnostics;
+		std::string m_key;
+		std::vector<char> m_cmdline;
+		std::vector<char*> m_cmdlineArgv;
+		int m_offsetToken = 0; // See CommandLineParser::makeDiagnostic
+		size_t m_offset = 0;
+	};
+
+private:
+	struct Profile
+	{
+		size_t selector;
+		std::string name;
+		std::vector<std::pair<size_t, std::string>> values;
+		ProfilePrecedence precedence;
+	};
+
+	struct Subscription
+	{
+		ChangeCallback callback;
+		std::vector<size_t> indices;
+		std::string prefix;
+	};
+
+	struct ConfigEntry
+	{
+		size_t idx;
+		uint64_t hash;
+		std::string value;
+	};
+
+	// Unescaped quoted fields of one list value in the order they occur, see getValueViews. The
+	// fields of a deque stay in place, so views to them stay valid while further fields are added.
+	struct UnescapedFields
+	{
+		std::deque<std::string> fields;
+		bool complete = false;
+	};
+
+	// Final values of all loaded config files, sorted by option index
+	struct ConfigLayer
+	{
+		std::vector<ConfigEntry> entries;
+		uint64_t hash = CommandLineHash::SEED;
+	};
+
+	static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+	// References are expanded recursively, deeper chains are reported instead of exhausting the stack
+	static constexpr size_t MAX_REFERENCE_DEPTH = 64;
+
+public:
+	CommandLineParser(const int argc, char** argv) :
+		m_options(),
+		m_argc(argc),
+		m_argv(argv),
+		m_helpOpt(CommandLineOption("-h", "--help", "Displays Help", CLO::HasValue::No))
+	{
+	}
+
+	// Uses the command line of the current process instead of argc / argv, e.g., to allow
+	// shared libraries to parse their own options (like --mylib.threads) without the host
+	// program forwarding its arguments. Options that were not registered are ignored, therefore,
+	// parse(false) should be used and no help option added, to not interfere with the host.
+	// Only plain read calls are used, so this is safe to call from a library constructor.
+	CommandLineParser() :
+		m_options(),
+		m_argc(0),
+		m_argv(nullptr),
+		m_helpOpt(CommandLineOption("-h", "--help", "Displays Help", CLO::HasValue::No))
+	{
+#ifdef _WIN32
+		m_argc = __argc;
+		m_argv = __argv;
+#else
+		readCmdline("/proc/self/cmdline");
+#endif
+		m_ignoreUnknown = true;
+	}
+
+#ifndef _WIN32
+	// Uses the command line of another process, see loadProcess
+	explicit CommandLineParser(const pid_t& pid) :
+		m_options(),
+		m_argc(0),
+		m_argv(nullptr),
+		m_helpOpt(CommandLineOption("-h", "--help", "Displays Help", CLO::HasValue::No))
+	{
+		loadProcess(pid);
+		m_ignoreUnknown = true;
+	}
+
+	// Replaces the arguments with the command line of the given process, reusing the
+	// internal buffers. Returns false if the command line could not be read, e.g., because
+	// the process already terminated. The option states are not touched, see reset.
+	bool loadProcess(const pid_t& pid)
+	{
+		char path[32];
+		std::snprintf(path, sizeof(path), "/proc/%d/cmdline", static_cast<int>(pid));
+		return readCmdline(path);
+	}
+#endif
+
+	// Splits the given command line, including the program name, into arguments, see loadCommandLine
+	explicit CommandLineParser(const std::string& commandLine) :
+		m_options(),
+		m_argc(0),
+		m_argv(nullptr),
+		m_helpOpt(CommandLineOption("-h", "--help", "Displays Help", CLO::HasValue::No))
+	{
+		loadCommandLine(commandLine);
+	}
+
+	// Replaces the arguments with the given command line, reusing the internal buffers.
+	// Arguments are separated by whitespace, single quotes preserve everything up to the next
+	// single quote, within double quotes and outside of quotes a backslash escapes the next
+	// character. Returns false if a quote is not terminated. The option states are not touched.
+	bool loadCommandLine(const std::string& commandLine)
+	{
+		const bool valid = splitCommandLine(commandLine, m_cmdline);
+		updateArgv();
+
+		return valid;
+	}
+
+	CommandLineParser(const CommandLineParser&) = delete;            // disable copy constructor
+	CommandLineParser& operator=(const CommandLineParser&) = delete; //  disable assignment constructor
+
+	void addOption(const CommandLineOption& opt)
+	{
+		m_options.push_back(opt);
+		addNames(m_options.size() - 1);
+
+		if (opt.isRequired())
+			m_requiredIdx.push_back(m_options.size() - 1);
+	}
+
+	void addSeparator()
+	{
+		m_options.push_back(CommandLineOption("", "", "", "", CLO::HasValue::No, CLO::Required::No, CLO::Separator::Yes));
+	}
+
+	// Sets the options listed in the given config file, values given on the command line or via
+	// profiles take precedence. Returns false if the file or an included file could not be
+	// read or contained unknown options or invalid values, which are reported to std::cerr.
+	// Invalid values are not applied and are also added to the diagnostics, where they are kept
+	// by match until the parser is reset or the configs are reloaded.
+	bool loadConfig(const std::string& path)
+	{
+		return loadConfigs({ path }, 1);
+	}
+
+	// Reads and tokenizes the given config files in parallel and applies them in the given
+	// order, i.e., later files override values of earlier ones, see loadConfig
+	bool loadConfigs(const std::vector<std::string>& paths, const size_t& threads = 0)
+	{
+		std::map<size_t, std::string> values;
+
+		for (const ConfigEntry& entry : m_configLayer.entries)
+			values[entry.idx] = entry.value;
+
+		return loadConfigs(paths, threads, values);
+	}
+
+	// Replaces all values previously loaded from config files with the values of the given
+	// files. Only the options whose effective value changed are updated and reported to the
+	// subscribers, nothing is done at all if the config did not change.
+	bool reloadConfigs(const std::vector<std::string>& paths, const size_t& threads = 0)
+	{
+		std::map<size_t, std::string> values;
+		m_configDiagnostics.clear();
+		return loadConfigs(paths, threads, values);
+	}
+
+	// Calls the callback once per config (re)load in which any of the options changed
+	size_t subscribe(const std::vector<CommandLineOption>& options, const ChangeCallback& callback)
+	{
+		Subscription subscription;
+		subscription.callback = callback;
+
+		for (const CommandLineOption& option : options)
+			subscription.indices.push_back(indexOf(option));
+
+		m_subscriptions.push_back(subscription);
+
+		return m_subscriptions.size() - 1;
+	}
+
+	// Subscribes to all options whose name starts with the given prefix, e.g., "--mylib."
+	size_t subscribe(const std::string& prefix, const ChangeCallback& callback)
+	{
+		Subscription subscription;
+		subscription.callback = callback;
+		subscription.prefix   = prefix;
+
+		m_subscriptions.push_back(subscription);
+
+		return m_subscriptions.size() - 1;
+	}
+
+	void unsubscribe(const size_t& id)
+	{
+		if (id < m_subscriptions.size())
+			m_subscriptions[id].callback = nullptr;
+	}
+
+	// The help option is always printed first, but appended to keep the indices of other options stable
+	void addHelpOption()
+	{
+		addOption(m_helpOpt);
+		m_helpIdx = m_options.size() - 1;
+	}
+
+	// Registers a named set of option values, applied when the selector option is given with
+	// the name as value, e.g., --profile low-latency. The options are resolved once here, so
+	// applying a profile only writes the precompiled values.
+	void addProfile(const CommandLineOption& selector, const std::string& name, const ProfileValues& values,
+					const ProfilePrecedence& precedence = ProfilePrecedence::CommandLine)
+	{
+		Profile profile;
+		profile.selector   = indexOf(selector);
+		profile.name       = name;
+		profile.precedence = precedence;
+
+		if (profile.selector == NOT_FOUND)
+		{
+			addOption(selector);
+			profile.selector = m_options.size() - 1;
+		}
+
+		for (const std::pair<CommandLineOption, std::string>& value : values)
+		{
+			const size_t idx = indexOf(value.first);
+
+			if (idx == NOT_FOUND)
+			{
+				std::cerr << "ERROR: Option (" << value.first.getArg() << " / " << value.first.getArgAlt() << ") of profile " << name << " not registered, exiting ..." << std::endl;
+				exit(-1);
+			}
+
+			profile.values.push_back({ idx, value.second });
+		}
+
+		m_profiles.push_back(profile);
+	}
+
+	// All problems found are reported at once, see getDiagnostics and printDiagnostics
+	void parse(const bool& requireMatch = true)
+	{
+		bool anyMatch = match();
+
+		if (isSet(m_helpOpt) || (!anyMatch && requireMatch))
+		{
+			printHelp();
+			exit(0);
+		}
+
+		if (!verify())
+		{
+			printDiagnostics(std::cerr);
+			exit(-1);
+		}
+	}
+
+	// Uses a precomputed help text, e.g., StaticHelp<options>::text(), instead of the layout of the options
+	void setHelpText(const std::string_view& text)
+	{
+		m_helpText = text;
+	}
+
+	// Moves the descriptions of all options into a single compressed block, which is only
+	// decompressed when the help is printed or searched. Options added afterwards keep their
+	// description, calling this again also compresses those.
+	void compressHelp()
+	{
+		std::string descriptions = CommandLineCompression::decompress(m_helpBlob);
+
+		m_descRanges.resize(m_options.size(), { 0, 0 });
+
+		for (size_t i = 0; i < m_options.size(); i++)
+		{
+			if (m_options[i].isDescriptionReleased())
+				continue;
+
+			const std::string desc = m_options[i].releaseDescription();
+			m_descRanges[i]        = { static_cast<uint32_t>(descriptions.size()), static_cast<uint32_t>(desc.size()) };
+			descriptions.append(desc);
+		}
+
+		m_helpBlob = CommandLineCompression::compress(descriptions);
+		m_helpBlob.shrink_to_fit();
+	}
+
+	// Returns the options whose names or descriptions contain the given text
+	std::vector<const CommandLineOption*> searchHelp(const std::string& text) const
+	{
+		const std::string descriptions = CommandLineCompression::decompress(m_helpBlob);
+		std::vector<const CommandLineOption*> result;
+
+		for (size_t i = 0; i < m_options.size(); i++)
+		{
+			const CommandLineOption& option = m_options[i];
+
+			if (option.getArg().find(text) != std::string::npos || option.getArgAlt().find(text) != std::string::npos || getDescription(i, descriptions).find(text) != std::string::npos)
+				result.push_back(&option);
+		}
+
+		return result;
+	}
+
+	CLO::MemoryUsage getMemoryUsage() const
+	{
+		CLO::MemoryUsage usage;
+
+		for (const CommandLineOption& option : m_options)
+			usage += option.getMemoryUsage();
+
+		usage.descriptions += m_helpBlob.capacity() + m_descRanges.capacity() * sizeof(std::pair<uint32_t, uint32_t>);
+
+		usage += m_helpOpt.getMemoryUsage();
+
+		// Each hash map node holds the element, the next pointer and the cached hash
+		const size_t nodeSize = 2 * sizeof(void*);
+
+		usage.index += m_names.bucket_count() * sizeof(void*) + m_names.size() * (sizeof(std::pair<const std::string, size_t>) + nodeSize);
+
+		for (const std::pair<const std::string, size_t>& name : m_names)
+			usage.index += CLO::heapSize(name.first);
+
+		usage.index += m_profiles.capacity() * sizeof(Profile) + m_subscriptions.capacity() * sizeof(Subscription);
+		usage.index += m_requiredIdx.capacity() * sizeof(size_t);
+
+		for (const Profile& profile : m_profiles)
+		{
+			usage.index += CLO::heapSize(profile.name) + profile.values.capacity() * sizeof(std::pair<size_t, std::string>);
+
+			for (const std::pair<size_t, std::string>& value : profile.values)
+				usage.index += CLO::heapSize(value.second);
+		}
+
+		for (const Subscription& subscription : m_subscriptions)
+			usage.index += subscription.indices.capacity() * sizeof(size_t) + CLO::heapSize(subscription.prefix);
+
+		usage.caches += m_cmdline.capacity() + m_cmdlineArgv.capacity() * sizeof(char*) + m_unknown.capacity() * sizeof(int);
+		usage.caches += m_invalidProfiles.capacity() * sizeof(size_t) + (m_diagnostics.capacity() + m_configDiagnostics.capacity()) * sizeof(Diagnostic);
+		usage.caches += m_configLayer.entries.capacity() * sizeof(ConfigEntry);
+
+		for (const Diagnostic& diag : m_diagnostics)
+			usage.caches += CLO::heapSize(diag.message);
+
+		for (const Diagnostic& diag : m_configDiagnostics)
+			usage.caches += CLO::heapSize(diag.message);
+
+		for (const ConfigEntry& entry : m_configLayer.entries)
+			usage.caches += CLO::heapSize(entry.value);
+
+		std::lock_guard<std::mutex> lock(m_expansionMutex);
+
+		usage.caches += m_expansions.bucket_count() * sizeof(void*) + m_expansions.size() * (sizeof(std::pair<const size_t, std::string>) + nodeSize);
+
+		for (const std::pair<const size_t, std::string>& expansion : m_expansions)
+			usage.caches += CLO::heapSize(expansion.second);
+
+		usage.caches += m_unescaped.size() * (sizeof(std::pair<const std::pair<size_t, char>, UnescapedFields>) + 3 * sizeof(void*));
+
+		for (const std::pair<const std::pair<size_t, char>, UnescapedFields>& unescaped : m_unescaped)
+		{
+			for (const std::string& field : unescaped.second.fields)
+				usage.caches += sizeof(std::string) + CLO::heapSize(field);
+		}
+
+		return usage;
+	}
+
+	// Prints the memory usage per category followed by the options using the most memory
+	void printMemoryUsage(std::ostream& os, const size_t& count = 10) const
+	{
+		const CLO::MemoryUsage usage = getMemoryUsage();
+		std::vector<std::pair<size_t, size_t>> largest;
+
+		os << "Schema: " << usage.schema() << " bytes (names " << usage.names << ", descriptions " << usage.descriptions << ", defaults " << usage.defaults
+		   << ", options " << usage.options << ", index " << usage.index << ")" << std::endl;
+		os << "Result: " << usage.result() << " bytes (values " << usage.values << ", caches " << usage.caches << ")" << std::endl;
+
+		for (size_t i = 0; i < m_options.size(); i++)
+			largest.push_back({ m_options[i].getMemoryUsage().total(), i });
+
+		const size_t shown = (std::min)(count, largest.size());
+		std::partial_sort(largest.begin(), largest.begin() + static_cast<std::ptrdiff_t>(shown), largest.end(), std::greater<std::pair<size_t, size_t>>());
+
+		for (size_t i = 0; i < shown; i++)
+		{
+			const CommandLineOption& option = m_options[largest[i].second];
+			const CLO::MemoryUsage optUsage = option.getMemoryUsage();
+
+			os << "  " << std::left << std::setw(30) << (option.getArg() + " " + option.getArgAltName()) << std::right << std::setw(8) << largest[i].first
+			   << " bytes (names " << optUsage.names << ", description " << optUsage.descriptions << ", default " << optUsage.defaults << ", value " << optUsage.values << ")" << std::endl;
+		}
+	}
+
+	// Same as parse, but neither prints the help nor exits, returns false if any problem was found
+	bool tryParse()
+	{
+		match();
+		return verify();
+	}
+
+	// Checks the state after matching for problems not related to single arguments, like missing
+	// required options, values set on the command line were already checked by match
+	bool verify()
+	{
+		for (const size_t& idx : m_invalidProfiles)
+			addDiagnostic(DiagnosticKind::RuleViolation, -1, "Unknown profile (" + m_options[idx].getValue() + ") for option " + getNames(m_options[idx]));
+
+		for (CommandLineOption& option : m_options)
+		{
+			if (option.isRequired() && !option.isSet() && !option.hasDefault())
+				addDiagnostic(DiagnosticKind::MissingRequired, -1, "Required option " + getNames(option) + " not set");
+			else if (option.getSource() == CLO::Source::Config || option.getSource() == CLO::Source::Profile)
+				checkValue(option, -1);
+			else if ((option.isBlob() || option.isNetwork()) && !option.isSet() && option.hasDefault())
+				checkValue(option, -1);
+		}
+
+		return m_diagnostics.empty();
+	}
+
+	const std::vector<Diagnostic>& getDiagnostics() const
+	{
+		return m_diagnostics;
+	}
+
+	// Prints each problem followed by the command line with the related argument marked, e.g.:
+	// ERROR: Unknown option (--fo)
+	//   prog --fo 1
+	//        ^~~~
+	void printDiagnostics(std::ostream& os) const
+	{
+		std::string cmdline;
+
+		for (int i = 0; i < m_argc; i++)
+			cmdline.append(i ? " " : "").append(m_argv[i]);
+
+		for (const Diagnostic& diag : m_diagnostics)
+		{
+			os << "ERROR: " << diag.message << std::endl;
+
+			if (diag.token < 0)
+				continue;
+
+			os << "  " << cmdline << std::endl;
+			os << "  " << std::string(diag.offset, ' ') << '^' << std::string(diag.length > 1 ? diag.length - 1 : 0, '~') << std::endl;
+		}
+	}
+
+	// Unknown options are ignored by default when the command line is read via procfs
+	void setIgnoreUnknown(const bool& ignore)
+	{
+		m_ignoreUnknown = ignore;
+	}
+
+	// Matches the arguments against the registered options without printing help or
+	// checking for required options, i.e., this never exits the program
+	bool match()
+	{
+		bool anyMatch = false;
+
+		// Invalid config values are loaded before matching, usually only once, and stay reported
+		m_unknown.clear();
+		m_diagnostics = m_configDiagnostics;
+		m_offsetToken = 0;
+		m_offset      = 0;
+		invalidateExpansions();
+
+		for (int i = 1; i < m_argc; i++)
+		{
+			std::string str  = m_argv[i];
+			const size_t idx = indexOfName(str);
+			bool matched     = false;
+
+			// Only the first occurrence of an option is used, see CommandLineOption::check
+			if (idx != NOT_FOUND && m_options[idx].matches(str) && m_options[idx].getSource() != CLO::Source::CommandLine)
+			{
+				CommandLineOption& option = m_options[idx];
+				const int count           = static_cast<int>(option.getArgCount());
+
+				// The option is only set if all its values are given, otherwise it keeps its previous value
+				if (i + count >= m_argc)
+					addDiagnostic(DiagnosticKind::MissingValue, i, count > 1 ? "Missing values for option " + getNames(option) + ", expected " + std::to_string(count) : "Missing value for option " + getNames(option), true);
+				else if (option.check(str) && count > 0)
+				{
+					option.setValues(m_argv + i + 1, static_cast<size_t>(count));
+					checkValue(option, i + 1);
+					i += count;
+				}
+
+				matched = true;
+			}
+
+			if (!matched && str.size() > 1 && str[0] == '-' && idx == NOT_FOUND)
+			{
+				m_unknown.push_back(i);
+
+				if (!m_ignoreUnknown)
+					addDiagnostic(DiagnosticKind::UnknownOption, i, "Unknown option (" + str + ")");
+			}
+
+			anyMatch |= matched;
+		}
+
+		applyProfiles();
+
+		return anyMatch;
+	}
+
+	// Parses the given arguments into result instead of the options of the parser, which allows
+	// to parse many command lines, also concurrently, against the same set of options. As for match,
+	// only the first occurrence of an option is used, later ones are skipped without their values.
+	// Neither help nor profiles are handled and values are not decoded, see Result.
+	// Returns false if there are any diagnostics.
+	bool parseInto(const int& argc, char** argv, Result& result) const
+	{
+		result.m_pParser = this;
+		result.clear();
+
+		for (int i = 1; i < argc; i++)
+		{
+			result.m_key.assign(argv[i]);
+			const size_t idx = indexOfName(result.m_key);
+			const CommandLineOption* pOption = idx != NOT_FOUND && m_options[idx].matches(result.m_key) ? &m_options[idx] : nullptr;
+
+			// Same as in match, a repeated option is neither used nor reported
+			if (pOption != nullptr && result.wasSet(idx))
+				continue;
+
+			if (pOption == nullptr)
+			{
+				if (result.m_key.size() > 1 && result.m_key[0] == '-' && idx == NOT_FOUND)
+				{
+					result.m_unknown.push_back(i);
+
+					if (!m_ignoreUnknown)
+						result.m_diagnostics.push_back(makeDiagnostic(argv, result.m_offsetToken, result.m_offset, DiagnosticKind::UnknownOption, i, "Unknown option (" + result.m_key + ")"));
+				}
+
+				continue;
+			}
+
+			const int count = static_cast<int>(pOption->getArgCount());
+
+			// The option is only set if all its values are given, a later occurrence may still set it
+			if (pOption->hasValue() && i + count >= argc)
+			{
+				result.m_diagnostics.push_back(makeDiagnostic(argv, result.m_offsetToken, result.m_offset, DiagnosticKind::MissingValue, i, count > 1 ? "Missing values for option " + getNames(*pOption) + ", expected " + std::to_string(count) : "Missing value for option " + getNames(*pOption), true));
+				continue;
+			}
+
+			result.mark(idx);
+			Result::Entry& entry = result.add(idx);
+			std::string& value   = entry.value;
+			const int first      = i + 1;
+
+			for (; pOption->hasValue() && i - first + 1 < count; i++)
+			{
+				value.append(i + 1 > first ? " " : "").append(argv[i + 1]);
+
+				if (count > 1)
+					entry.fieldEnds.push_back(value.size());
+			}
+
+			if (!pOption->hasValue())
+				continue;
+
+			if (!pOption->hasValidType(value, &entry.fieldEnds))
+				result.m_diagnostics.push_back(makeDiagnostic(argv, result.m_offsetToken, result.m_offset, DiagnosticKind::BadType, first, "Invalid value (" + value + ") for option " + getNames(*pOption) + ", expected " + CLO::getTypeName(pOption->getType())));
+			else if (!pOption->validate(value))
+				result.m_diagnostics.push_back(makeDiagnostic(argv, result.m_offsetToken, result.m_offset, DiagnosticKind::ValidationFailed, first, "Invalid value (" + value + ") for option " + getNames(*pOption)));
+		}
+
+		result.finish();
+
+		for (const size_t& idx : m_requiredIdx)
+		{
+			const CommandLineOption& option = m_options[idx];
+
+			if (result.find(idx) == nullptr && !option.isSet() && !option.hasDefault())
+				result.m_diagnostics.push_back(makeDiagnostic(argv, result.m_offsetToken, result.m_offset, DiagnosticKind::MissingRequired, -1, "Required option " + getNames(option) + " not set"));
+		}
+
+		return result.m_diagnostics.empty();
+	}
+
+	// Splits the command line, including the program name, as loadCommandLine does into buffers
+	// of the result and parses it, see parseInto above
+	bool parseInto(const std::string_view& commandLine, Result& result) const
+	{
+		const bool quoted = splitCommandLine(commandLine, result.m_cmdline);
+		const int argc    = updateArgv(result.m_cmdline, result.m_cmdlineArgv);
+		const bool valid  = parseInto(argc, result.m_cmdlineArgv.data(), result);
+
+		if (!quoted)
+			result.m_diagnostics.push_back(makeDiagnostic(nullptr, result.m_offsetToken, result.m_offset, DiagnosticKind::RuleViolation, -1, "Unterminated quote in command line"));
+
+		return valid && quoted;
+	}
+
+	// Resets all options to their unset state, allowing to reuse the parser, e.g., via loadProcess
+	void reset()
+	{
+		for (CommandLineOption& option : m_options)
+			option.reset();
+
+		m_unknown.clear();
+		m_invalidProfiles.clear();
+		m_diagnostics.clear();
+		m_configDiagnostics.clear();
+		m_configLayer = ConfigLayer();
+		invalidateExpansions();
+	}
+
+	// Returns the arguments starting with '-' that did not match any registered option
+	std::vector<std::string> getUnknownOptions() const
+	{
+		std::vector<std::string> unknown;
+
+		for (const int& idx : m_unknown)
+			unknown.push_back(m_argv[idx]);
+
+		return unknown;
+	}
+
+	bool isSet(const CommandLineOption& opt) const
+	{
+		const size_t idx = indexOf(opt);
+
+		if (idx == NOT_FOUND)
+			return false;
+		else
+			return m_options[idx].isSet();
+	}
+
+	std::string getValue(const CommandLineOption& opt) const
+	{
+		const size_t idx = indexOf(opt);
+
+		if (idx == NOT_FOUND)
+			return "";
+		else if (m_interpolate && hasReference(m_options[idx].getValue()))
+			return getExpandedValue(idx);
+		else
+			return m_options[idx].getValue();
+	}
+
+	template<typename T>
+	T getValueAs(const CommandLineOption& opt) const
+	{
+		const size_t idx = indexOf(opt);
+		T value          = T();
+
+		if (idx == NOT_FOUND)
+			return value;
+
+		if (!m_interpolate || !hasReference(m_options[idx].getValue()))
+			return m_options[idx].getValueAs<T>();
+
+		CLO::convertValue(getExpandedValue(idx), value);
+
+		return value;
+	}
+
+	// For options declared at compile time, the number of arguments is checked against T.
+	// Before C++20 a template argument cannot refer to an array element, e.g., options[1],
+	// for options declared in an array use getValueAs<options, 1, T>() instead.
+	template<const StaticOption& Option, typename T>
+	T getValueAs() const
+	{
+		static_assert(!Option.hasValue || CLO::argCountOf<T>() == Option.argCount, "Number of arguments does not match the option");
+
+		return getValueAs<T>(CommandLineOption(Option));
+	}
+
+	template<const auto& Options, size_t Index, typename T>
+	T getValueAs() const
+	{
+		static_assert(Index < sizeof(Options) / sizeof(Options[0]), "Option index out of range");
+		static_assert(!Options[Index].hasValue || CLO::argCountOf<T>() == Options[Index].argCount, "Number of arguments does not match the option");
+
+		return getValueAs<T>(CommandLineOption(Options[Index]));
+	}
+
+	std::vector<std::string> getValueList(const CommandLineOption& opt, const std::string delim = ",", const ListFormat& format = ListFormat::Plain) const
+	{
+		if (indexOf(opt) == NOT_FOUND)
 			return std::vector<std::string>();
+		else if (format == ListFormat::Plain)
+			return splitString(getValue(opt), delim);
+
+		const std::vector<std::string_view> views = getValueViews(opt, delim.empty() ? ',' : delim.at(0));
+		return std::vector<std::string>(views.begin(), views.end());
+	}
+
+	// Splits a CSV list value without copying, the views refer to the stored value. Only fields
+	// containing escaped quotes are unescaped into a buffer of the parser, once per option and
+	// delimiter. The views are valid until the values change, e.g., by the next parse. A quote not
+	// at the start of a field or an unterminated quoted field is kept as is.
+	std::vector<std::string_view> getValueViews(const CommandLineOption& opt, const char& delim = ',') const
+	{
+		std::vector<std::string_view> fields;
+		const size_t idx = indexOf(opt);
+
+		if (idx == NOT_FOUND || m_options[idx].getValue().empty())
+			return fields;
+
+		std::lock_guard<std::mutex> lock(m_expansionMutex);
+		std::vector<size_t> stack;
+		bool failed              = false;
+		const std::string& value = m_interpolate && hasReference(m_options[idx].getValue()) ? expand(idx, stack, failed) : m_options[idx].getValue();
+
+		const char* pPos           = value.data();
+		const char* pEnd           = value.data() + value.size();
+		UnescapedFields& unescaped = m_unescaped[{ idx, delim }];
+		size_t escapedIdx          = 0;
+
+		while (true)
+		{
+			const char* pNext = nullptr;
+
+			if (pPos < pEnd && *pPos == '"')
+				pNext = splitQuoted(pPos, pEnd, delim, unescaped, escapedIdx, fields);
+
+			if (pNext == nullptr)
+			{
+				pNext = static_cast<const char*>(std::memchr(pPos, delim, pEnd - pPos));
+				fields.emplace_back(pPos, (pNext ? pNext : pEnd) - pPos);
+			}
+
+			if (pNext == nullptr || pNext == pEnd)
+				break;
+
+			pPos = pNext + 1;
+		}
+
+		unescaped.complete = true;
+
+		return fields;
+	}
+
+	// Copies the effective values (expanded if enabled) of all options, e.g., to be replicated
+	// via CommandLineReplicas. Values are looked up by the names of the options.
+	CommandLineSnapshot getSnapshot() const
+	{
+		CommandLineSnapshot snapshot;
+
+		for (size_t i = 0; i < m_options.size(); i++)
+		{
+			const CommandLineOption& option = m_options[i];
+			std::vector<std::string> names;
+
+			if (!option.getArg().empty())
+				names.push_back(option.getArg());
+
+			if (!option.getArgAltName().empty())
+				names.push_back(option.getArgAltName());
+
+			// Separators have no names and cannot be looked up
+			if (names.empty())
+				continue;
+
+			snapshot.add(names, m_interpolate && hasReference(option.getValue()) ? getExpandedValue(i) : option.getValue(), option.isSet());
+		}
+
+		return snapshot;
+	}
+
+	// Bytes of a Hex or Base64 option, decoded whenever the value is set, e.g., by the command line or a
+	// config file, and valid until the value changes. Default values are decoded by verify.
+	CommandLineEncoding::Blob getBlob(const CommandLineOption& opt) const
+	{
+		const size_t idx = indexOf(opt);
+
+		if (idx == NOT_FOUND)
+			return CommandLineEncoding::Blob();
+		else
+			return m_options[idx].getBlob();
+	}
+
+	// The elements refer to the value stored in the parser, i.e., they stay valid until the value changes
+	CommandLineNetwork::List<CommandLineNetwork::Address> getAddresses(const CommandLineOption& opt, const char& delim = ',') const
+	{
+		return getNetworkList<CommandLineNetwork::Address>(opt, delim);
+	}
+
+	CommandLineNetwork::List<CommandLineNetwork::Endpoint> getEndpoints(const CommandLineOption& opt, const char& delim = ',') const
+	{
+		return getNetworkList<CommandLineNetwork::Endpoint>(opt, delim);
+	}
+
+	CommandLineNetwork::List<CommandLineNetwork::Network> getNetworks(const CommandLineOption& opt, const char& delim = ',') const
+	{
+		return getNetworkList<CommandLineNetwork::Network>(opt, delim);
+	}
+
+	// Enables the expansion of references in values: ${NAME} and ${env:NAME} are replaced by the
+	// environment variable, ${opt:--name} by the (expanded) value of the option, $$ by $.
+	// Values are expanded on first access and cached until any value changes. Cyclic, unknown or
+	// more than 64 levels deep nested references are added to the diagnostics and the value is
+	// returned unexpanded.
+	void setInterpolation(const bool& enable)
+	{
+		m_interpolate = enable;
+		invalidateExpansions();
+	}
+
+private:
+#ifndef _WIN32
+	bool readCmdline(const char* pPath)
+	{
+		m_cmdline.clear();
+
+		int fd = open(pPath, O_RDONLY | O_CLOEXEC);
+
+		if (fd >= 0)
+		{
+			// procfs reports a size of 0, therefore, read until EOF
+			const size_t chunkSize = 4096;
+			size_t size            = 0;
+			ssize_t bytesRead      = 0;
+
+			do
+			{
+				m_cmdline.resize(size + chunkSize);
+				bytesRead = read(fd, m_cmdline.data() + size, chunkSize);
+
+				if (bytesRead > 0)
+					size += static_cast<size_t>(bytesRead);
+			} while (bytesRead > 0);
+
+			close(fd);
+			m_cmdline.resize(size);
+		}
+
+		const bool valid = !m_cmdline.empty();
+
+		// The arguments are already NUL separated, so argv can point directly into the buffer
+		if (m_cmdline.empty() || m_cmdline.back() != '\0')
+			m_cmdline.push_back('\0');
+
+		updateArgv();
+
+		return valid;
+	}
+#endif
+
+	void updateArgv()
+	{
+		m_argc = updateArgv(m_cmdline, m_cmdlineArgv);
+		m_argv = m_cmdlineArgv.data();
+	}
+
+	// Points argv to the null separated arguments in buffer, returns the number of arguments
+	static int updateArgv(std::vector<char>& buffer, std::vector<char*>& argv)
+	{
+		argv.clear();
+
+		for (size_t i = 0; i < buffer.size(); i++)
+		{
+			if (i == 0 || buffer[i - 1] == '\0')
+				argv.push_back(&buffer[i]);
+		}
+
+		const int argc = static_cast<int>(argv.size());
+		argv.push_back(nullptr);
+
+		return argc;
+	}
+
+	// Splits the command line into null separated arguments, see loadCommandLine,
+	// returns false for an unterminated quote
+	static bool splitCommandLine(const std::string_view& commandLine, std::vector<char>& buffer)
+	{
+		char quote   = 0;
+		bool inToken = false;
+
+		buffer.clear();
+
+		for (size_t i = 0; i < commandLine.size(); i++)
+		{
+			const char c = commandLine[i];
+
+			if (quote == 0 && (c == ' ' || c == '\t' || c == '\n' || c == '\r'))
+			{
+				if (inToken)
+					buffer.push_back('\0');
+
+				inToken = false;
+				continue;
+			}
+
+			inToken = true;
+
+			if (c == '\\' && quote != '\'' && i + 1 < commandLine.size())
+				buffer.push_back(commandLine[++i]);
+			else if (quote == 0 && (c == '\'' || c == '"'))
+				quote = c;
+			else if (c == quote)
+				quote = 0;
+			else
+				buffer.push_back(c);
+		}
+
+		if (inToken || buffer.empty())
+			buffer.push_back('\0');
+
+		return quote == 0;
+	}
+
+	void printHelp()
+	{
+#ifdef _WIN32
+		char drive[_MAX_DRIVE];
+		char dir[_MAX_DIR];
+		char pFileName[_MAX_FNAME];
+		char ext[_MAX_EXT];
+		_splitpath_s(m_argv[0], drive, dir, pFileName, ext);
+#else
+		char* pFileName = basename(m_argv[0]);
+#endif
+
+		std::cout << "Usage: " << pFileName << " option" << std::endl
+				  << std::endl;
+
+		// A precomputed help text requires no layout at all
+		if (!m_helpText.empty())
+		{
+			std::cout.write(m_helpText.data(), static_cast<std::streamsize>(m_helpText.size()));
+			return;
+		}
+
+		updateAddSpaces();
+
+		const std::string descriptions = CommandLineCompression::decompress(m_helpBlob);
+
+		if (m_helpIdx != NOT_FOUND)
+			printOption(m_helpIdx, descriptions);
+
+		for (size_t i = 0; i < m_options.size(); i++)
+		{
+			if (i != m_helpIdx)
+				printOption(i, descriptions);
+		}
+	}
+
+	void printOption(const size_t& idx, const std::string& descriptions) const
+	{
+		if (!m_options[idx].isDescriptionReleased())
+		{
+			std::cout << m_options[idx];
+			return;
+		}
+
+		CommandLineOption option(m_options[idx]);
+		option.setDescription(getDescription(idx, descriptions));
+		std::cout << option;
+	}
+
+	std::string getDescription(const size_t& idx, const std::string& descriptions) const
+	{
+		if (!m_options[idx].isDescriptionReleased() || idx >= m_descRanges.size())
+			return m_options[idx].getDescription();
+
+		return descriptions.substr(m_descRanges[idx].first, m_descRanges[idx].second);
+	}
+
+	bool loadConfigs(const std::vector<std::string>& paths, const size_t& threads, std::map<size_t, std::string>& values)
+	{
+		std::vector<ConfigFile::Entries> entries(paths.size());
+		std::vector<std::vector<std::string>> errors(paths.size());
+
+		CommandLineWorkers::forEach(paths.size(), threads, [&](const size_t&, const size_t& idx) {
+			ConfigFile::flatten(paths[idx], entries[idx], errors[idx]);
+		});
+
+		bool success = true;
+
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			for (const std::pair<std::string, std::string>& entry : entries[i])
+			{
+				const size_t idx = indexOfKey(entry.first);
+
+				if (idx == NOT_FOUND)
+				{
+					errors[i].push_back("Unknown option (" + entry.first + ") in config file " + paths[i]);
+					continue;
+				}
+
+				DiagnosticKind kind;
+				const std::string error = checkValue(m_options[idx], entry.second, kind);
+
+				if (error.empty())
+				{
+					values[idx] = entry.second;
+					continue;
+				}
+
+				// Invalid values are not applied, a value loaded before stays in effect
+				errors[i].push_back(error + " in config file " + paths[i]);
+				addDiagnostic(kind, -1, errors[i].back());
+				m_configDiagnostics.push_back(m_diagnostics.back());
+
+				const ConfigEntry* pOld = findConfigEntry(idx);
+
+				if (pOld && values.find(idx) == values.end())
+					values[idx] = pOld->value;
+			}
+
+			for (const std::string& error : errors[i])
+				std::cerr << "ERROR: " << error << std::endl;
+
+			success &= errors[i].empty();
+		}
+
+		ConfigLayer layer;
+
+		for (const std::pair<const size_t, std::string>& value : values)
+		{
+			const uint64_t hash = CommandLineHash::fnv1a(value.second);
+			layer.entries.push_back({ value.first, hash, value.second });
+			layer.hash = CommandLineHash::fnv1a(hash, CommandLineHash::fnv1a(value.first, layer.hash));
+		}
+
+		updateConfigLayer(layer);
+
+		return success;
+	}
+
+	// Compares the sorted entries of both layers, which is skipped entirely if the layer hashes match
+	void updateConfigLayer(ConfigLayer& layer)
+	{
+		if (layer.hash == m_configLayer.hash && layer.entries.size() == m_configLayer.entries.size())
+			return;
+
+		const std::vector<ConfigEntry>& oldEntries = m_configLayer.entries;
+		const std::vector<ConfigEntry>& newEntries = layer.entries;
+		std::vector<size_t> changed;
+		size_t o = 0, n = 0;
+
+		while (o < oldEntries.size() || n < newEntries.size())
+		{
+			const size_t oldIdx = o < oldEntries.size() ? oldEntries[o].idx : NOT_FOUND;
+			const size_t newIdx = n < newEntries.size() ? newEntries[n].idx : NOT_FOUND;
+			const size_t idx    = (std::min)(oldIdx, newIdx);
+			const ConfigEntry* pOld = oldIdx == idx ? &oldEntries[o++] : nullptr;
+			const ConfigEntry* pNew = newIdx == idx ? &newEntries[n++] : nullptr;
+
+			if (pOld && pNew && pOld->hash == pNew->hash)
+				continue;
+
+			CommandLineOption& option = m_options[idx];
+
+			// Values of higher sources are not affected by the config
+			if (option.getSource() > CLO::Source::Config)
+				continue;
+
+			if (pNew)
+				option.setValue(pNew->value, CLO::Source::Config);
+			else
+				option.reset();
+
+			changed.push_back(idx);
+		}
+
+		m_configLayer = std::move(layer);
+
+		if (!changed.empty())
+			invalidateExpansions();
+
+		notify(changed);
+	}
+
+	void notify(const std::vector<size_t>& changed) const
+	{
+		if (changed.empty())
+			return;
+
+		for (const Subscription& subscription : m_subscriptions)
+		{
+			if (!subscription.callback)
+				continue;
+
+			std::vector<const CommandLineOption*> options;
+
+			for (const size_t& idx : changed)
+			{
+				if (subscription.prefix.empty() ? contains(subscription.indices, idx) : hasPrefix(m_options[idx], subscription.prefix))
+					options.push_back(&m_options[idx]);
+			}
+
+			if (!options.empty())
+				subscription.callback(options);
+		}
+	}
+
+	// Values of Hex, Base64 and network options were already decoded when set, see CommandLineOption::decode
+	void checkValue(CommandLineOption& option, const int& token)
+	{
+		const std::string& value = option.getValue();
+
+		if (option.isBlob() || option.isNetwork() ? !option.decode() : !option.hasValidType(value, &option.getFieldEnds()))
+			addDiagnostic(DiagnosticKind::BadType, token, "Invalid value (" + value + ") for option " + getNames(option) + ", expected " + CLO::getTypeName(option.getType()));
+		else if (!option.validate(value))
+			addDiagnostic(DiagnosticKind::ValidationFailed, token, "Invalid value (" + value + ") for option " + getNames(option));
+	}
+
+	// Returns the problem with the value, an empty string if it is valid for the option
+	static std::string checkValue(const CommandLineOption& option, const std::string& value, DiagnosticKind& kind)
+	{
+		kind = option.hasValidType(value) ? DiagnosticKind::ValidationFailed : DiagnosticKind::BadType;
+
+		if (kind == DiagnosticKind::BadType)
+			return "Invalid value (" + value + ") for option " + getNames(option) + ", expected " + CLO::getTypeName(option.getType());
+		else if (!option.validate(value))
+			return "Invalid value (" + value + ") for option " + getNames(option);
+		else
+			return "";
+	}
+
+	const ConfigEntry* findConfigEntry(const size_t& idx) const
+	{
+		std::vector<ConfigEntry>::const_iterator it = std::lower_bound(m_configLayer.entries.begin(), m_configLayer.entries.end(), idx,
+																	   [](const ConfigEntry& entry, const size_t& i) { return entry.idx < i; });
+
+		return it != m_configLayer.entries.end() && it->idx == idx ? &*it : nullptr;
+	}
+
+	// With afterToken set, the position right after the argument is marked, e.g., for a missing value
+	void addDiagnostic(const DiagnosticKind& kind, const int& token, const std::string& message, const bool& afterToken = false)
+	{
+		m_diagnostics.push_back(makeDiagnostic(m_argv, m_offsetToken, m_offset, kind, token, message, afterToken));
+	}
+
+	// Also used by parseInto, offsetToken and offset carry the position of the previous diagnostic of
+	// the same arguments
+	static Diagnostic makeDiagnostic(char** argv, int& offsetToken, size_t& offset, const DiagnosticKind& kind, const int& token, const std::string& message, const bool& afterToken = false)
+	{
+		Diagnostic diag = { kind, token, 0, 0, message };
+
+		if (token >= 0)
+		{
+			// Diagnostics are usually added in argument order, so continue from the last offset
+			if (token < offsetToken)
+			{
+				offsetToken = 0;
+				offset      = 0;
+			}
+
+			for (; offsetToken < token; offsetToken++)
+				offset += std::char_traits<char>::length(argv[offsetToken]) + 1;
+
+			diag.offset = offset;
+			diag.length = std::char_traits<char>::length(argv[token]);
+
+			if (afterToken)
+			{
+				diag.offset += diag.length + 1;
+				diag.length = 1;
+			}
+		}
+
+		return diag;
+	}
+
+	static std::string getNames(const CommandLineOption& option)
+	{
+		return "(" + option.getArg() + " / " + option.getArgAlt() + ")";
+	}
+
+	// Lists are parsed once when the value is set, other delimiters or unset values not checked yet by
+	// verify are parsed on demand
+	template<typename T>
+	CommandLineNetwork::List<T> getNetworkList(const CommandLineOption& opt, const char& delim) const
+	{
+		const size_t idx = indexOf(opt);
+
+		if (idx == NOT_FOUND || m_options[idx].getValue().empty())
+			return CommandLineNetwork::List<T>();
+
+		const CommandLineNetwork::List<T>* pList = delim == ',' ? m_options[idx].getList<T>() : nullptr;
+
+		return pList ? *pList : CommandLineNetwork::parseList<T>(m_options[idx].getValue(), delim);
+	}
+
+	static bool hasReference(const std::string& value)
+	{
+		return value.find('$') != std::string::npos;
+	}
+
+	void invalidateExpansions()
+	{
+		std::lock_guard<std::mutex> lock(m_expansionMutex);
+		m_expansions.clear();
+		m_unescaped.clear();
+	}
+
+	// Adds the quoted field starting at pPos, returns the delimiter (or end) following the
+	// closing quote, nullptr if the field is not properly quoted. Fields with escaped quotes are
+	// unescaped on the first split of a value only, later splits use the stored fields in order.
+	const char* splitQuoted(const char* pPos, const char* pEnd, const char& delim, UnescapedFields& unescaped, size_t& escapedIdx, std::vector<std::string_view>& fields) const
+	{
+		const char* pBegin = pPos + 1;
+		bool escaped       = false;
+
+		while (true)
+		{
+			const char* pQuote = static_cast<const char*>(std::memchr(pPos + 1, '"', pEnd - pPos - 1));
+
+			if (pQuote == nullptr)
+				return nullptr;
+
+			if (pQuote + 1 < pEnd && pQuote[1] == '"')
+			{
+				escaped = true;
+				pPos    = pQuote + 1;
+				continue;
+			}
+
+			if (pQuote + 1 != pEnd && pQuote[1] != delim)
+				return nullptr;
+
+			if (!escaped)
+				fields.emplace_back(pBegin, pQuote - pBegin);
+			else if (unescaped.complete)
+				fields.emplace_back(unescaped.fields[escapedIdx++]);
+			else
+			{
+				std::string& field = unescaped.fields.emplace_back();
+				field.reserve(pQuote - pBegin);
+
+				for (const char* p = pBegin; p < pQuote; p++)
+				{
+					field.push_back(*p);
+					p += *p == '"';
+				}
+
+				fields.emplace_back(field);
+			}
+
+			return pQuote + 1;
+		}
+	}
+
+	std::string getExpandedValue(const size_t& idx) const
+	{
+		std::lock_guard<std::mutex> lock(m_expansionMutex);
+		std::vector<size_t> stack;
+		bool failed = false;
+		return expand(idx, stack, failed);
+	}
+
+	// Expands the value of the given option, the stack contains the options currently being
+	// expanded and is used to detect cyclic references. Cyclic, unknown or too deeply nested
+	// references (see MAX_REFERENCE_DEPTH) are reported as RuleViolation, the options on the failing reference chain keep their unexpanded value.
+	// Results, including failed ones, are cached, so each problem is reported once.
+	const std::string& expand(const size_t& idx, std::vector<size_t>& stack, bool& failed) const
+	{
+		std::unordered_map<size_t, std::string>::const_iterator it = m_expansions.find(idx);
+
+		if (it != m_expansions.end())
+			return it->second;
+
+		if (contains(stack, idx))
+		{
+			m_diagnostics.push_back({ DiagnosticKind::RuleViolation, -1, 0, 0, "Cyclic reference in value of option " + getNames(m_options[idx]) });
+			failed = true;
+			return m_options[idx].getValue();
+		}
+
+		if (stack.size() >= MAX_REFERENCE_DEPTH)
+		{
+			m_diagnostics.push_back({ DiagnosticKind::RuleViolation, -1, 0, 0, "References nested too deeply in value of option " + getNames(m_options[idx]) });
+			failed = true;
+			return m_options[idx].getValue();
+		}
+
+		stack.push_back(idx);
+
+		const std::string& value = m_options[idx].getValue();
+		std::string expanded;
+		size_t pos = 0;
+
+		while (pos < value.size() && !failed)
+		{
+			const size_t start = value.find('$', pos);
+			expanded.append(value, pos, start - pos);
+
+			if (start == std::string::npos)
+				break;
+
+			if (value.compare(start, 2, "$$") == 0)
+			{
+				expanded.push_back('$');
+				pos = start + 2;
+				continue;
+			}
+
+			const size_t end = value.find('}', start);
+
+			if (value.compare(start, 2, "${") != 0 || end == std::string::npos)
+			{
+				expanded.push_back('$');
+				pos = start + 1;
+				continue;
+			}
+
+			std::string name = value.substr(start + 2, end - start - 2);
+
+			if (name.compare(0, 4, "opt:") == 0)
+			{
+				const size_t refIdx = indexOfName(name.substr(4));
+
+				if (refIdx == NOT_FOUND)
+				{
+					m_diagnostics.push_back({ DiagnosticKind::RuleViolation, -1, 0, 0, "Unknown option (" + name.substr(4) + ") referenced by option " + getNames(m_options[idx]) });
+					failed = true;
+					break;
+				}
+
+				expanded.append(expand(refIdx, stack, failed));
+			}
+			else
+			{
+				if (name.compare(0, 4, "env:") == 0)
+					name.erase(0, 4);
+
+				const char* pEnv = std::getenv(name.c_str());
+				expanded.append(pEnv ? pEnv : "");
+			}
+
+			pos = end + 1;
+		}
+
+		stack.pop_back();
+
+		return m_expansions[idx] = failed ? value : expanded;
+	}
+
+	size_t indexOfName(const std::string& name) const
+	{
+		std::unordered_map<std::string, size_t>::const_iterator it = m_names.find(name);
+		return it == m_names.end() ? NOT_FOUND : it->second;
+	}
+
+	// If multiple options share a name, the first one registered is used
+	void addNames(const size_t& idx)
+	{
+		if (!m_options[idx].getArg().empty())
+			m_names.emplace(m_options[idx].getArg(), idx);
+
+		if (!m_options[idx].getArgAltName().empty())
+			m_names.emplace(m_options[idx].getArgAltName(), idx);
+	}
+
+	static bool hasPrefix(const CommandLineOption& option, const std::string& prefix)
+	{
+		return option.getArg().compare(0, prefix.size(), prefix) == 0 || option.getArgAlt().compare(0, prefix.size(), prefix) == 0;
+	}
+
+	// Finds the option by its name without leading dashes, e.g., "threads" for "--threads"
+	size_t indexOfKey(const std::string& key) const
+	{
+		const size_t idx = indexOfName("--" + key);
+		return idx != NOT_FOUND ? idx : indexOfName("-" + key);
+	}
+
+	size_t indexOf(const CommandLineOption& opt) const
+	{
+		const size_t idx = indexOfName(opt.getArg().empty() ? opt.getArgAltName() : opt.getArg());
+
+		if (idx != NOT_FOUND && m_options[idx] == opt)
+			return idx;
+
+		// Only options sharing names or without any name require a full search
+		if (idx == NOT_FOUND && !(opt.getArg().empty() && opt.getArgAltName().empty()))
+			return NOT_FOUND;
+
+		CommandLineOptions::const_iterator result = std::find(m_options.begin(), m_options.end(), opt);
+
+		if (result == m_options.end())
+			return NOT_FOUND;
+		else
+			return static_cast<size_t>(result - m_options.begin());
+	}
+
+	void applyProfiles()
+	{
+		std::vector<size_t> applied;
+
+		m_invalidProfiles.clear();
+
+		for (const Profile& profile : m_profiles)
+		{
+			const CommandLineOption& selector = m_options[profile.selector];
+
+			if (!selector.isSet() || profile.name != selector.getValue())
+				continue;
+
+			const bool force = profile.precedence == ProfilePrecedence::Profile;
+
+			for (const std::pair<size_t, std::string>& value : profile.values)
+				m_options[value.first].setValue(value.second, CLO::Source::Profile, force);
+
+			applied.push_back(profile.selector);
+		}
+
+		for (const Profile& profile : m_profiles)
+		{
+			if (!m_options[profile.selector].isSet() || contains(applied, profile.selector) || contains(m_invalidProfiles, profile.selector))
+				continue;
+
+			m_invalidProfiles.push_back(profile.selector);
+		}
+	}
+
+	static bool contains(const std::vector<size_t>& values, const size_t& value)
+	{
+		return std::find(values.begin(), values.end(), value) != values.end();
+	}
+
+	void updateAddSpaces()
+	{
+		// Find the element with the largest argument length and use that length as the max length
+		size_t maxLen = std::max_element(m_options.begin(), m_options.end(), [](const CommandLineOption& a, const CommandLineOption& b) { return a.getArgsLength() < b.getArgsLength(); })->getArgsLength();
+
+		for (CommandLineOption& option : m_options)
+			option.setSpaceAdd(maxLen);
+	}
+
+	static std::vector<std::string> splitString(const std::string& s, const std::string& delimiter = " ")
+	{
+		std::vector<std::string> split;
+		std::string item;
+		std::istringstream stream(s);
+
+		char delim = ',';
+
+		if (!delimiter.empty())
+			delim = delimiter.at(0);
+
+		while (std::getline(stream, item, delim))
+			split.push_back(item);
+
+		return split;
+	}
+
+private:
+	CommandLineOptions m_options;
+	int m_argc;
+	char** m_argv;
+	CommandLineOption m_helpOpt;
+	std::vector<char> m_cmdline;
+	std::vector<char*> m_cmdlineArgv;
+	std::vector<int> m_unknown;
+	std::vector<Profile> m_profiles;
+	std::vector<size_t> m_invalidProfiles;
+	std::vector<Subscription> m_subscriptions;
+	ConfigLayer m_configLayer;
+	bool m_interpolate = false;
+	bool m_ignoreUnknown = false;
+	mutable std::vector<Diagnostic> m_diagnostics; // Also appended to by the (const) expansion of values
+	std::vector<Diagnostic> m_configDiagnostics;   // Invalid config values, restored by match
+	std::unordered_map<std::string, size_t> m_names;
+	int m_offsetToken = 0;
+	size_t m_offset = 0;
+	mutable std::mutex m_expansionMutex;
+	mutable std::unordered_map<size_t, std::string> m_expansions;
+	mutable std::map<std::pair<size_t, char>, UnescapedFields> m_unescaped;
+	std::vector<size_t> m_requiredIdx;
+	size_t m_helpIdx = NOT_FOUND;
+	std::vector<uint8_t> m_helpBlob;
+	std::string_view m_helpText;
+	std::vector<std::pair<uint32_t, uint32_t>> m_descRanges;
+};
+
+// Reuses results of CommandLineParser::parseInto, e.g., for services parsing a command line per
+// request. Results returned to the pool keep their buffers, so once the pool is warmed up parsing
+// does not allocate (as long as values fit into the buffers of previous parses).
+// The pool and the parser have to outlive all handles.
+class CommandLineResultPool
+{
+	struct Releaser
+	{
+		CommandLineResultPool* pPool;
+
+		void operator()(CommandLineParser::Result* pResult) const
+		{
+			pPool->release(pResult);
+		}
+	};
+
+public:
+	using Handle = std::unique_ptr<CommandLineParser::Result, Releaser>;
+
+	explicit CommandLineResultPool(const CommandLineParser& parser) :
+		m_parser(parser)
+	{
+	}
+
+	CommandLineResultPool(const CommandLineResultPool&) = delete;
+	CommandLineResultPool& operator=(const CommandLineResultPool&) = delete;
+
+	~CommandLineResultPool()
+	{
+		for (CommandLineParser::Result* pResult : m_free)
+			delete pResult;
+	}
+
+	Handle acquire()
+	{
+		CommandLineParser::Result* pResult = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!m_free.empty())
+			{
+				pResult = m_free.back();
+				m_free.pop_back();
+			}
+		}
+
+		return Handle(pResult ? pResult : new CommandLineParser::Result(), Releaser{ this });
+	}
+
+	Handle parse(const int& argc, char** argv)
+	{
+		Handle result = acquire();
+		m_parser.parseInto(argc, argv, *result);
+		return result;
+	}
+
+	// Number of results currently available for reuse
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_free.size();
+	}
+
+private:
+	void release(CommandLineParser::Result* pResult)
+	{
+		pResult->clear();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_free.push_back(pResult);
+	}
+
+private:
+	const CommandLineParser& m_parser;
+	mutable std::mutex m_mutex;
+	std::vector<CommandLineParser::Result*> m_free;
+};
+
+// Caches the results of parsing command line strings, e.g., for services receiving the same
+// commands over and over again. Results are immutable and shared, a hit skips tokenizing,
+// matching and validating completely. The cache is split into shards with their own lock and
+// LRU list, selected by the hash of the command line. The parser has to outlive the cache and
+// must not be changed while the cache is in use, as the cached results depend on it.
+class CommandLineResultCache
+{
+public:
+	using ResultPtr = std::shared_ptr<const CommandLineParser::Result>;
+
+	struct Statistics
+	{
+		uint64_t hits      = 0;
+		uint64_t misses    = 0;
+		uint64_t evictions = 0;
+		size_t size        = 0;
+	};
+
+	CommandLineResultCache(const CommandLineParser& parser, const size_t& capacity, const size_t& shards = 16) :
+		m_parser(parser),
+		m_shards((std::max)(static_cast<size_t>(1), shards)),
+		m_shardCapacity((std::max)(static_cast<size_t>(1), (capacity + m_shards.size() - 1) / m_shards.size()))
+	{
+	}
+
+	ResultPtr parse(const std::string_view& commandLine)
+	{
+		const uint64_t hash = CommandLineHash::fnv1a(commandLine);
+
+		// The low bits of FNV-1a are poorly mixed, therefore, the high bits select the shard
+		Shard& shard = m_shards[(hash >> 32) % m_shards.size()];
+
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			std::unordered_map<uint64_t, LruList::iterator>::iterator it = shard.index.find(hash);
+
+			// The command line is compared as well, as the hash alone may collide
+			if (it != shard.index.end() && it->second->commandLine == commandLine)
+			{
+				shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+				m_hits++;
+				return it->second->pResult;
+			}
+		}
+
+		m_misses++;
+
+		// Parsed without holding the lock, concurrent misses for the same command line parse twice
+		std::shared_ptr<CommandLineParser::Result> pResult = std::make_shared<CommandLineParser::Result>();
+		m_parser.parseInto(commandLine, *pResult);
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		std::unordered_map<uint64_t, LruList::iterator>::iterator it = shard.index.find(hash);
+
+		if (it != shard.index.end())
+		{
+			shard.lru.erase(it->second);
+			shard.index.erase(it);
+		}
+
+		shard.lru.push_front({ hash, std::string(commandLine), pResult });
+		shard.index[hash] = shard.lru.begin();
+
+		if (shard.lru.size() > m_shardCapacity)
+		{
+			shard.index.erase(shard.lru.back().hash);
+			shard.lru.pop_back();
+			m_evictions++;
+		}
+
+		return pResult;
+	}
+
+	Statistics getStatistics() const
+	{
+		Statistics stats;
+		stats.hits      = m_hits;
+		stats.misses    = m_misses;
+		stats.evictions = m_evictions;
+
+		for (const Shard& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			stats.size += shard.lru.size();
+		}
+
+		return stats;
+	}
+
+	void clear()
+	{
+		for (Shard& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			shard.lru.clear();
+			shard.index.clear();
+		}
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t hash;
+		std::string commandLine;
+		ResultPtr pResult;
+	};
+
+	using LruList = std::list<Entry>;
+
+	struct Shard
+	{
+		mutable std::mutex mutex;
+		LruList lru; // Most recently used first
+		std::unordered_map<uint64_t, LruList::iterator> index;
+	};
+
+private:
+	const CommandLineParser& m_parser;
+	std::vector<Shard> m_shards;
+	size_t m_shardCapacity;
+	std::atomic<uint64_t> m_hits{ 0 };
+	std::atomic<uint64_t> m_misses{ 0 };
+	std::atomic<uint64_t> m_evictions{ 0 };
+};
+
+// Overrides a few values of a base (CommandLineParser, CommandLineParser::Result or another
+// overlay) without copying it, e.g., per request on top of the process wide configuration.
+// Up to N overrides are stored inline, so creating and discarding an overlay does not allocate
+// as long as the values fit into the small string buffer. Options are matched by address first,
+// then by comparison. The base and the overridden options have to outlive the overlay.
+template<typename Base, size_t N = 4>
+class CommandLineOverlay
+{
+public:
+	explicit CommandLineOverlay(const Base& base) :
+		m_base(base)
+	{
+	}
+
+	void set(const CommandLineOption& opt, const std::string_view& value)
+	{
+		std::string* pValue = find(opt);
+
+		if (pValue)
+			pValue->assign(value);
+		else if (m_count < N)
+			m_inline[m_count++] = { &opt, std::string(value) };
+		else
+			m_overflow.push_back({ &opt, std::string(value) });
+	}
+
+	bool isOverridden(const CommandLineOption& opt) const
+	{
+		return find(opt) != nullptr;
+	}
+
+	bool isSet(const CommandLineOption& opt) const
+	{
+		return isOverridden(opt) || m_base.isSet(opt);
+	}
+
+	std::string getValue(const CommandLineOption& opt) const
+	{
+		const std::string* pValue = find(opt);
+		return pValue ? *pValue : std::string(m_base.getValue(opt));
+	}
+
+	template<typename T>
+	T getValueAs(const CommandLineOption& opt) const
+	{
+		const std::string* pValue = find(opt);
+
+		if (pValue == nullptr)
+			return m_base.template getValueAs<T>(opt);
+
+		T value = T();
+		CLO::convertValue(*pValue, value);
+		return value;
+	}
+
+	const Base& getBase() const
+	{
+		return m_base;
+	}
+
+private:
+	struct Entry
+	{
+		const CommandLineOption* pOption;
+		std::string value;
+	};
+
+	const std::string* find(const CommandLineOption& opt) const
+	{
+		return const_cast<CommandLineOverlay*>(this)->find(opt);
+	}
+
+	std::string* find(const CommandLineOption& opt)
+	{
+		for (size_t i = 0; i < m_count; i++)
+		{
+			if (m_inline[i].pOption == &opt)
+				return &m_inline[i].value;
+		}
+
+		for (Entry& entry : m_overflow)
+		{
+			if (entry.pOption == &opt)
+				return &entry.value;
+		}
+
+		// Copies of an overridden option are found by comparison
+		for (size_t i = 0; i < m_count; i++)
+		{
+			if (*m_inline[i].pOption == opt)
+				return &m_inline[i].value;
+		}
+
+		for (Entry& entry : m_overflow)
+		{
+			if (*entry.pOption == opt)
+				return &entry.value;
+		}
+
+		return nullptr;
+	}
+
+private:
+	const Base& m_base;
+	std::array<Entry, N> m_inline;
+	size_t m_count = 0;
+	std::vector<Entry> m_overflow;
+};
+
+// Memory maps an archive written by CommandLineArchive (see there) and answers counting queries over it,
+// e.g., the number of command lines with --threads > 32 grouped by --queue:
+// reader.countBy({ { "--threads", Op::Greater, "32" } }, "--queue")
+// Predicates are evaluated once per distinct value of a column, the rows are then selected
+// 64 at a time via the dictionary codes and the bitmap of set rows.
+class CommandLineArchiveReader
+{
+public:
+	enum class Op
+	{
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual
+	};
+
+	// Values are compared as numbers if both sides are numbers, otherwise as strings.
+	// Rows not setting the option never match.
+	struct Predicate
+	{
+		std::string column;
+		Op op;
+		std::string value;
+	};
+
+	struct Group
+	{
+		std::string value;
+		bool set; // False for the rows not setting the option
+		uint64_t count;
+	};
+
+public:
+	explicit CommandLineArchiveReader(const std::string& path)
+	{
+#ifndef _WIN32
+		const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		struct stat st;
+
+		if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void* pMap = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (pMap != MAP_FAILED)
+			{
+				m_pData  = static_cast<const char*>(pMap);
+				m_size   = static_cast<size_t>(st.st_size);
+				m_mapped = true;
+			}
+		}
+
+		if (fd >= 0)
+			close(fd);
+#endif
+
+		if (!m_mapped)
+		{
+			std::ifstream file(path, std::ios::binary);
+			m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			m_pData = m_buffer.data();
+			m_size  = m_buffer.size();
+		}
+
+		m_valid = readColumns();
+	}
+
+	CommandLineArchiveReader(const CommandLineArchiveReader&) = delete;
+	CommandLineArchiveReader& operator=(const CommandLineArchiveReader&) = delete;
+
+	~CommandLineArchiveReader()
+	{
+#ifndef _WIN32
+		if (m_mapped)
+			munmap(const_cast<char*>(m_pData), m_size);
+#endif
+	}
+
+	bool isValid() const
+	{
+		return m_valid;
+	}
+
+	uint64_t rows() const
+	{
+		return m_rows;
+	}
+
+	std::vector<std::string> getColumns() const
+	{
+		std::vector<std::string> names;
+
+		for (const Column& column : m_columns)
+			names.push_back(std::string(column.name));
+
+		return names;
+	}
+
+	bool isSet(const std::string& column, const uint64_t& row) const
+	{
+		const Column* pColumn = findColumn(column);
+		return pColumn && row < m_rows && (pColumn->pSet[row / 64] >> (row % 64)) & 1;
+	}
+
+	// The view refers to the mapped archive and is valid as long as the reader exists
+	std::string_view getValue(const std::string& column, const uint64_t& row) const
+	{
+		const Column* pColumn = findColumn(column);
+
+		if (!isSet(column, row))
+			return std::string_view();
+
+		return value(*pColumn, pColumn->pCodes[row]);
+	}
+
+	uint64_t count(const std::vector<Predicate>& where) const
+	{
+		uint64_t count = 0;
+
+		for (const uint64_t& word : select(where))
+			count += popCount(word);
+
+		return count;
+	}
+
+	// Number of matching rows per value of the given column, sorted by value, rows not setting the option last
+	std::vector<Group> countBy(const std::vector<Predicate>& where, const std::string& column) const
+	{
+		const std::vector<uint64_t> rows = select(where);
+		const Column* pColumn            = findColumn(column);
+		const size_t values              = pColumn ? pColumn->values : 0;
+		std::vector<uint64_t> counts(values + 1, 0);
+
+		for (size_t w = 0; w < rows.size(); w++)
+		{
+			const uint64_t set = pColumn ? pColumn->pSet[w] : 0;
+
+			for (uint64_t bits = rows[w]; bits != 0; bits &= bits - 1)
+			{
+				const size_t bit = countTrailingZeros(bits);
+				counts[(set >> bit) & 1 ? pColumn->pCodes[w * 64 + bit] : values]++;
+			}
+		}
+
+		std::vector<Group> groups;
+
+		for (size_t i = 0; i < values; i++)
+		{
+			if (counts[i] > 0)
+				groups.push_back({ std::string(value(*pColumn, static_cast<uint32_t>(i))), true, counts[i] });
+		}
+
+		std::sort(groups.begin(), groups.end(), [](const Group& lhs, const Group& rhs) { return lhs.value < rhs.value; });
+
+		if (counts[values] > 0)
+			groups.push_back({ "", false, counts[values] });
+
+		return groups;
+	}
+
+private:
+	friend class CommandLineArchive;
+
+	static constexpr uint64_t MAGIC     = 0x3141504c43ull; // "CLPA1" in little endian
+	static constexpr size_t HEADER_SIZE = 24;              // Magic, rows and columns
+	static constexpr size_t COLUMN_SIZE = 48;              // Offsets and sizes of the sections of a column
+
+	struct Column
+	{
+		std::string_view name;
+		uint64_t values;
+		const uint64_t* pIndex;
+		const uint32_t* pCodes;
+		const uint64_t* pSet;
+	};
+
+	uint64_t get(const size_t& offset) const
+	{
+		uint64_t value = 0;
+
+		if (offset + sizeof(value) <= m_size)
+			std::memcpy(&value, m_pData + offset, sizeof(value));
+
+		return value;
+	}
+
+	bool inRange(const uint64_t& offset, const uint64_t& size) const
+	{
+		return offset <= m_size && size <= m_size - offset;
+	}
+
+	bool readColumns()
+	{
+		if (get(0) != MAGIC)
+			return false;
+
+		m_rows                 = get(8);
+		const uint64_t columns = get(16);
+		const uint64_t words   = (m_rows + 63) / 64;
+
+		if (columns > m_size || m_rows > m_size || !inRange(HEADER_SIZE, columns * COLUMN_SIZE))
+			return false;
+
+		for (uint64_t c = 0; c < columns; c++)
+		{
+			const size_t header = HEADER_SIZE + c * COLUMN_SIZE;
+			Column column;
+			column.values = get(header + 16);
+
+			if (!inRange(get(header), get(header + 8)) || column.values > m_size || !inRange(get(header + 24), (column.values + 1) * sizeof(uint64_t))
+				|| !inRange(get(header + 32), m_rows * sizeof(uint32_t)) || !inRange(get(header + 40), words * sizeof(uint64_t)))
+				return false;
+
+			column.name   = std::string_view(m_pData + get(header), get(header + 8));
+			column.pIndex = reinterpret_cast<const uint64_t*>(m_pData + get(header + 24));
+			column.pCodes = reinterpret_cast<const uint32_t*>(m_pData + get(header + 32));
+			column.pSet   = reinterpret_cast<const uint64_t*>(m_pData + get(header + 40));
+
+			for (uint64_t i = 0; i < column.values; i++)
+			{
+				if (column.pIndex[i] > column.pIndex[i + 1] || !inRange(column.pIndex[i], column.pIndex[i + 1] - column.pIndex[i]))
+					return false;
+			}
+
+			for (uint64_t row = 0; row < m_rows; row++)
+			{
+				if (column.pCodes[row] >= column.values && ((column.pSet[row / 64] >> (row % 64)) & 1))
+					return false;
+			}
+
+			m_columns.push_back(column);
+		}
+
+		return true;
+	}
+
+	const Column* findColumn(const std::string& name) const
+	{
+		for (const Column& column : m_columns)
+		{
+			if (column.name == name)
+				return &column;
+		}
+
+		return nullptr;
+	}
+
+	std::string_view value(const Column& column, const uint32_t& code) const
+	{
+		return std::string_view(m_pData + column.pIndex[code], column.pIndex[code + 1] - column.pIndex[code]);
+	}
+
+	static bool matches(const std::string_view& value, const Predicate& pred, const bool& numeric, const double& number)
+	{
+		double valueNumber = 0;
+		int cmp;
+
+		if (numeric && CLO::convertValue(value, valueNumber))
+			cmp = valueNumber < number ? -1 : (valueNumber > number ? 1 : 0);
 		else
-			return splitString(result->getValue(), delim);
+			cmp = value.compare(pred.value);
+
+		switch (pred.op)
+		{
+			case Op::Equal:
+				return cmp == 0;
+			case Op::NotEqual:
+				return cmp != 0;
+			case Op::Less:
+				return cmp < 0;
+			case Op::LessEqual:
+				return cmp <= 0;
+			case Op::Greater:
+				return cmp > 0;
+			default:
+				return cmp >= 0;
+		}
 	}
 
-private:
-	void printHelp()
+	// Bitmap of the rows matching all predicates
+	std::vector<uint64_t> select(const std::vector<Predicate>& where) const
 	{
-#ifdef _WIN32
-		char drive[_MAX_DRIVE];
-		char dir[_MAX_DIR];
-		char pFileName[_MAX_FNAME];
-		char ext[_MAX_EXT];
-		_splitpath_s(m_argv[0], drive, dir, pFileName, ext);
+		const size_t words = static_cast<size_t>((m_rows + 63) / 64);
+		std::vector<uint64_t> rows(words, ~0ull);
+
+		if (m_rows % 64 != 0)
+			rows.back() = (1ull << (m_rows % 64)) - 1;
+
+		for (const Predicate& pred : where)
+		{
+			const Column* pColumn = findColumn(pred.column);
+
+			if (pColumn == nullptr)
+				return std::vector<uint64_t>(words, 0);
+
+			double number      = 0;
+			const bool numeric = CLO::convertValue(pred.value, number);
+
+			// Evaluated once per distinct value, the rows only look up the result
+			std::vector<uint8_t> table(pColumn->values);
+
+			for (size_t i = 0; i < table.size(); i++)
+				table[i] = matches(value(*pColumn, static_cast<uint32_t>(i)), pred, numeric, number);
+
+			for (size_t w = 0; w < words; w++)
+			{
+				const uint64_t set = rows[w] & pColumn->pSet[w];
+				uint64_t bits      = 0;
+
+				for (uint64_t candidates = set; candidates != 0; candidates &= candidates - 1)
+				{
+					const size_t bit = countTrailingZeros(candidates);
+					bits |= static_cast<uint64_t>(table[pColumn->pCodes[w * 64 + bit]]) << bit;
+				}
+
+				rows[w] = bits;
+			}
+		}
+
+		return rows;
+	}
+
+	static size_t popCount(const uint64_t& value)
+	{
+#ifdef _MSC_VER
+		return static_cast<size_t>(__popcnt64(value));
 #else
-		char* pFileName = basename(m_argv[0]);
+		return static_cast<size_t>(__builtin_popcountll(value));
 #endif
+	}
 
-		updateAddSpaces();
-		std::cout << "Usage: " << pFileName << " option" << std::endl
-				  << std::endl;
+	// The value must not be 0
+	static size_t countTrailingZeros(const uint64_t& value)
+	{
+#ifdef _MSC_VER
+		unsigned long idx;
+		_BitScanForward64(&idx, value);
+		return idx;
+#else
+		return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+	}
+
+private:
+	const char* m_pData = nullptr;
+	size_t m_size       = 0;
+	bool m_mapped       = false;
+	bool m_valid        = false;
+	std::vector<char> m_buffer;
+	uint64_t m_rows = 0;
+	std::vector<Column> m_columns;
+};
+
+// Stores parse results column-wise, one column per option (named after its long name, e.g.,
+// "--threads", or its short name if it has none), to analyze many command lines without parsing
+// them again. Each column holds a dictionary of its distinct values, a 32 bit dictionary code per
+// row and a bitmap of the rows that set the option. Archives are written in native byte order
+// and read via CommandLineArchiveReader. To append to an existing archive, load it first.
+class CommandLineArchive
+{
+public:
+	void append(const CommandLineParser::Result& result)
+	{
+		result.forEachSet([this](const CommandLineOption& option, const std::string& value)
+		{
+			Column& column = getColumn(option.getArgAltName().empty() ? option.getArg() : option.getArgAltName());
+			column.codes.resize(m_rows + 1, 0);
+			column.codes[m_rows] = column.encode(value);
+			column.set.resize(m_rows / 64 + 1, 0);
+			column.set[m_rows / 64] |= 1ull << (m_rows % 64);
+		});
+
+		m_rows++;
+	}
+
+	size_t rows() const
+	{
+		return m_rows;
+	}
+
+	// Replaces the content with the given archive, returns false if it cannot be read
+	bool load(const std::string& path)
+	{
+		const CommandLineArchiveReader reader(path);
+
+		if (!reader.isValid())
+			return false;
+
+		*this  = CommandLineArchive();
+		m_rows = static_cast<size_t>(reader.rows());
+
+		for (const CommandLineArchiveReader::Column& source : reader.m_columns)
+		{
+			Column& column = getColumn(std::string(source.name));
+
+			for (uint32_t i = 0; i < source.values; i++)
+				column.encode(std::string(reader.value(source, i)));
+
+			column.codes.assign(source.pCodes, source.pCodes + m_rows);
+			column.set.assign(source.pSet, source.pSet + (m_rows + 63) / 64);
+		}
+
+		return true;
+	}
+
+	// Written via CommandLineFiles::replace, so readers never see a partial archive
+	bool save(const std::string& path) const
+	{
+		std::vector<char> data(CommandLineArchiveReader::HEADER_SIZE + m_columns.size() * CommandLineArchiveReader::COLUMN_SIZE, 0);
+		put(data, 0, CommandLineArchiveReader::MAGIC);
+		put(data, 8, m_rows);
+		put(data, 16, m_columns.size());
+
+		for (size_t c = 0; c < m_columns.size(); c++)
+		{
+			const Column& column = m_columns[c];
+			const size_t header  = CommandLineArchiveReader::HEADER_SIZE + c * CommandLineArchiveReader::COLUMN_SIZE;
+
+			put(data, header, append(data, column.name.data(), column.name.size()));
+			put(data, header + 8, column.name.size());
+			put(data, header + 16, column.values.size());
+
+			// Absolute offsets of the dictionary values, followed by the end of the last value
+			std::vector<uint64_t> index;
+			std::string values;
+
+			for (const std::string& value : column.values)
+			{
+				index.push_back(values.size());
+				values.append(value);
+			}
+
+			index.push_back(values.size());
+			const uint64_t valuesOffset = append(data, values.data(), values.size());
+
+			for (uint64_t& offset : index)
+				offset += valuesOffset;
+
+			put(data, header + 24, append(data, index.data(), index.size() * sizeof(uint64_t)));
+
+			std::vector<uint32_t> codes = column.codes;
+			codes.resize(m_rows, 0);
+			put(data, header + 32, append(data, codes.data(), codes.size() * sizeof(uint32_t)));
+
+			std::vector<uint64_t> set = column.set;
+			set.resize((m_rows + 63) / 64, 0);
+			put(data, header + 40, append(data, set.data(), set.size() * sizeof(uint64_t)));
+		}
+
+		return CommandLineFiles::replace(path, [&data](std::ostream& file) { file.write(data.data(), static_cast<std::streamsize>(data.size())); });
+	}
+
+private:
+	struct Column
+	{
+		std::string name;
+		std::vector<std::string> values;
+		std::unordered_map<std::string, uint32_t> codeOf;
+		std::vector<uint32_t> codes; // Might be shorter than the number of rows, the rest is unset
+		std::vector<uint64_t> set;
+
+		uint32_t encode(const std::string& value)
+		{
+			std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> res = codeOf.emplace(value, static_cast<uint32_t>(values.size()));
+
+			if (res.second)
+				values.push_back(value);
+
+			return res.first->second;
+		}
+	};
+
+	Column& getColumn(const std::string& name)
+	{
+		std::unordered_map<std::string, size_t>::const_iterator it = m_columnOf.find(name);
+
+		if (it != m_columnOf.end())
+			return m_columns[it->second];
+
+		m_columnOf.emplace(name, m_columns.size());
+		m_columns.emplace_back();
+		m_columns.back().name = name;
+
+		return m_columns.back();
+	}
+
+	static void put(std::vector<char>& data, const size_t& offset, const uint64_t& value)
+	{
+		std::memcpy(data.data() + offset, &value, sizeof(value));
+	}
+
+	// Appends the bytes padded to 8 bytes, returns their offset
+	static uint64_t append(std::vector<char>& data, const void* pData, const size_t& size)
+	{
+		const size_t offset = data.size();
+		data.resize(offset + (size + 7) / 8 * 8, 0);
+
+		if (size > 0)
+			std::memcpy(data.data() + offset, pData, size);
+
+		return offset;
+	}
+
+private:
+	size_t m_rows = 0;
+	std::deque<Column> m_columns;
+	std::unordered_map<std::string, size_t> m_columnOf;
+};
+
+#ifndef _WIN32
+// Parses the command lines of running processes against a given set of options, e.g., to
+// check the effective flags of many processes against a policy
+class CommandLineAudit
+{
+public:
+	struct Entry
+	{
+		pid_t pid;
+		bool valid;
+		std::vector<std::string> values;
+		std::vector<std::string> unknown;
+	};
+
+public:
+	explicit CommandLineAudit(const std::vector<CommandLineOption>& options) :
+		m_options(options)
+	{
+	}
+
+	std::vector<Entry> run(const std::vector<pid_t>& pids, const size_t& threads = 0) const
+	{
+		std::vector<Entry> entries(pids.size());
+		std::vector<std::unique_ptr<CommandLineParser>> parsers;
+
+		// One parser per worker, reused for all processes handled by that worker. Unknown options
+		// are listed, but not reported as diagnostics, which nothing would read.
+		for (size_t i = 0; i < CommandLineWorkers::count(pids.size(), threads); i++)
+		{
+			parsers.emplace_back(new CommandLineParser(0, nullptr));
+			parsers.back()->setIgnoreUnknown(true);
+
+			for (const CommandLineOption& option : m_options)
+				parsers.back()->addOption(option);
+		}
+
+		CommandLineWorkers::forEach(pids.size(), threads, [&](const size_t& worker, const size_t& idx) {
+			CommandLineParser& parser = *parsers[worker];
+			Entry& entry              = entries[idx];
+
+			entry.pid   = pids[idx];
+			entry.valid = parser.loadProcess(pids[idx]);
+
+			if (!entry.valid)
+				return;
+
+			parser.reset();
+			parser.match();
+
+			for (const CommandLineOption& option : m_options)
+				entry.values.push_back(parser.getValue(option));
+
+			entry.unknown = parser.getUnknownOptions();
+		});
+
+		return entries;
+	}
+
+	// Prints one tab separated line per process, unset options without a default are shown as '-'.
+	// Values are taken from other processes, therefore, tabs, newlines, backslashes and other
+	// control characters are escaped (\t, \n, \\, \xHH), so every process is exactly one row.
+	void print(std::ostream& os, const std::vector<Entry>& entries) const
+	{
+		os << "PID";
 
 		for (const CommandLineOption& option : m_options)
-			std::cout << option;
+			os << '\t' << (option.getArgAltName().empty() ? option.getArg() : option.getArgAltName());
+
+		os << "\tUNKNOWN" << std::endl;
+
+		for (const Entry& entry : entries)
+		{
+			if (!entry.valid)
+				continue;
+
+			os << entry.pid;
+
+			for (const std::string& value : entry.values)
+				os << '\t' << (value.empty() ? "-" : escape(value));
+
+			os << '\t';
+
+			for (size_t i = 0; i < entry.unknown.size(); i++)
+				os << (i ? "," : "") << escape(entry.unknown[i]);
+
+			os << std::endl;
+		}
 	}
 
-	void updateAddSpaces()
+	static std::vector<pid_t> listProcesses()
 	{
-		// Find the element with the largest argument length and use that length as the max length
-		size_t maxLen = std::max_element(m_options.begin(), m_options.end(), [](CommandLineOption a, CommandLineOption b) { return a.getArgsLength() < b.getArgsLength(); })->getArgsLength();
+		std::vector<pid_t> pids;
+		DIR* pDir = opendir("/proc");
 
-		for (CommandLineOption& option : m_options)
-			option.setSpaceAdd(maxLen);
+		if (pDir == nullptr)
+			return pids;
+
+		while (dirent* pEntry = readdir(pDir))
+		{
+			char* pEnd = nullptr;
+			long pid   = std::strtol(pEntry->d_name, &pEnd, 10);
+
+			if (pid > 0 && *pEnd == '\0')
+				pids.push_back(static_cast<pid_t>(pid));
+		}
+
+		closedir(pDir);
+
+		return pids;
 	}
 
-	static std::vector<std::string> splitString(const std::string& s, const std::string& delimiter = " ")
+private:
+	static std::string escape(const std::string& str)
 	{
-		std::vector<std::string> split;
-		std::string item;
-		std::istringstream stream(s);
+		static const char HEX[] = "0123456789abcdef";
+		std::string escaped;
 
-		char delim = ',';
+		for (const char& c : str)
+		{
+			const unsigned char u = static_cast<unsigned char>(c);
 
-		if (!delimiter.empty())
-			delim = delimiter.at(0);
+			if (c == '\\')
+				escaped.append("\\\\");
+			else if (c == '\t')
+				escaped.append("\\t");
+			else if (c == '\n')
+				escaped.append("\\n");
+			else if (u < 0x20 || u == 0x7F)
+				escaped.append("\\x").append(1, HEX[u >> 4]).append(1, HEX[u & 0xF]);
+			else
+				escaped.push_back(c);
+		}
 
-		while (std::getline(stream, item, delim))
-			split.push_back(item);
+		return escaped;
+	}
 
-		return split;
+private:
+	std::vector<CommandLineOption> m_options;
+};
+#endif
+
+// Help text of options declared at compile time, laid out the same way as by the parser,
+// but entirely at compile time, e.g.:
+// static constexpr StaticOption options[] = { { "-t", "--threads", "Number of threads", "4" } };
+// parser.setHelpText(StaticHelp<options>::text(width));
+// The text is precomputed for each of the common terminal widths in WIDTHS.
+template<const auto& Options>
+class StaticHelp
+{
+public:
+	static constexpr std::array<size_t, 4> WIDTHS = { 80, 100, 120, 160 };
+
+	// Returns the text for the largest precomputed width not exceeding the given width
+	static constexpr std::string_view text(const size_t& width = 80)
+	{
+		if (width >= WIDTHS[3])
+			return view(PAGE_160);
+		else if (width >= WIDTHS[2])
+			return view(PAGE_120);
+		else if (width >= WIDTHS[1])
+			return view(PAGE_100);
+		else
+			return view(PAGE_80);
 	}
 
 private:
-	CommandLineOptions m_options;
-	int m_argc;
-	char** m_argv;
-	CommandLineOption m_helpOpt;
+	static constexpr size_t SPACE_ARG_DESC = 4;
+	static constexpr size_t MIN_DESC_LEN   = 20;
+
+	// The description including the required and default suffixes, without building a string
+	struct Description
+	{
+		const StaticOption& opt;
+
+		constexpr size_t length() const
+		{
+			return strLength(opt.desc) + (opt.required ? strLength(" (required)") : 0) + (strLength(opt.defaultValue) ? strLength(" DEFAULT: ") + strLength(opt.defaultValue) : 0);
+		}
+
+		constexpr char operator[](size_t idx) const
+		{
+			const char* parts[] = { opt.desc, opt.required ? " (required)" : "", strLength(opt.defaultValue) ? " DEFAULT: " : "", opt.defaultValue };
+
+			for (const char* pPart : parts)
+			{
+				const size_t length = strLength(pPart);
+
+				if (idx < length)
+					return pPart[idx];
+
+				idx -= length;
+			}
+
+			return '\0';
+		}
+	};
+
+	static constexpr size_t strLength(const char* pStr)
+	{
+		size_t length = 0;
+
+		while (pStr[length] != '\0')
+			length++;
+
+		return length;
+	}
+
+	static constexpr void put(char* pOut, size_t& size, const char& c)
+	{
+		if (pOut)
+			pOut[size] = c;
+
+		size++;
+	}
+
+	static constexpr void put(char* pOut, size_t& size, const char* pStr)
+	{
+		while (*pStr != '\0')
+			put(pOut, size, *pStr++);
+	}
+
+	// Writes the help text into pOut, if given, and returns its size, see CommandLineOption::operator<<
+	static constexpr size_t layout(const size_t& maxLineLen, char* pOut)
+	{
+		size_t size     = 0;
+		size_t addSpace = 0;
+
+		for (const StaticOption& opt : Options)
+		{
+			if (!opt.separator)
+				addSpace = (std::max)(addSpace, strLength(opt.arg) + 2 + strLength(opt.argAlt));
+		}
+
+		const size_t indent = SPACE_ARG_DESC + addSpace;
+		const size_t width  = indent + MIN_DESC_LEN < maxLineLen ? maxLineLen - indent : MIN_DESC_LEN;
+
+		for (const StaticOption& opt : Options)
+		{
+			if (opt.separator)
+			{
+				put(pOut, size, '\n');
+				continue;
+			}
+
+			const size_t argsLength = strLength(opt.arg) + 2 + strLength(opt.argAlt);
+
+			put(pOut, size, opt.arg);
+			put(pOut, size, ", ");
+			put(pOut, size, opt.argAlt);
+
+			for (size_t i = argsLength; i < indent; i++)
+				put(pOut, size, ' ');
+
+			const Description desc{ opt };
+			const size_t length = desc.length();
+			size_t pos          = 0;
+
+			while (length - pos > width)
+			{
+				size_t spacePos = pos + width;
+				size_t next     = spacePos;
+
+				for (size_t i = pos + width; i > pos; i--)
+				{
+					if (desc[i] == ' ')
+					{
+						spacePos = i;
+						next     = i + 1;
+						break;
+					}
+				}
+
+				for (size_t i = pos; i < spacePos; i++)
+					put(pOut, size, desc[i]);
+
+				put(pOut, size, '\n');
+
+				for (size_t i = 0; i < indent; i++)
+					put(pOut, size, ' ');
+
+				pos = next;
+			}
+
+			for (size_t i = pos; i < length; i++)
+				put(pOut, size, desc[i]);
+
+			put(pOut, size, '\n');
+		}
+
+		return size;
+	}
+
+	template<size_t Width, size_t Size>
+	static constexpr std::array<char, Size> page()
+	{
+		std::array<char, Size> text{};
+		layout(Width, text.data());
+		return text;
+	}
+
+	template<size_t Size>
+	static constexpr std::string_view view(const std::array<char, Size>& text)
+	{
+		return std::string_view(text.data(), Size);
+	}
+
+	static constexpr std::array<char, layout(80, nullptr)> PAGE_80   = page<80, layout(80, nullptr)>();
+	static constexpr std::array<char, layout(100, nullptr)> PAGE_100 = page<100, layout(100, nullptr)>();
+	static constexpr std::array<char, layout(120, nullptr)> PAGE_120 = page<120, layout(120, nullptr)>();
+	static constexpr std::array<char, layout(160, nullptr)> PAGE_160 = page<160, layout(160, nullptr)>();
 };
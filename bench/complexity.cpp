@@ -0,0 +1,625 @@
+/*
+ *  File: complexity.cpp
+ *  Copyright (c) 2023 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+// Adversarial complexity and fuzzing harness
+// Each case builds a worst-case input of size n, e.g., many options, long words or deep
+// reference chains, and measures the time (minimum of several repetitions) and the number
+// of allocations of one operation while n doubles. The growth exponent log2(t(2n) / t(n))
+// is compared against the declared bound of the case, i.e., 1 for O(n), and any case growing
+// faster is reported and makes the program fail. Afterwards, random schemas and command lines
+// are parsed and checked for invariants of the diagnostics and against parseInto.
+//
+// Usage: complexity [--quick] [--case <name>] [--fuzz <iterations>] [--seed <seed>]
+
+#include "CommandLineParser.h"
+
+#include <cmath>
+#include <new>
+#include <random>
+
+namespace
+{
+std::atomic<uint64_t> g_allocations(0);
+} // namespace
+
+// GCC cannot tell that the replaced operator new allocates via malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pMem = std::malloc(size ? size : 1))
+		return pMem;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pMem) noexcept
+{
+	std::free(pMem);
+}
+
+void operator delete(void* pMem, std::size_t) noexcept
+{
+	std::free(pMem);
+}
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Prepares the input of size n outside of the measurement and returns the operation to measure
+using Operation = std::function<void()>;
+using Setup     = std::function<Operation(const size_t&)>;
+
+struct Case
+{
+	std::string name;
+	double bound; // Maximum growth exponent, i.e., 1 for O(n)
+	Setup setup;
+};
+
+struct Sample
+{
+	size_t n;
+	double seconds;
+	uint64_t allocations;
+};
+
+// Working sets outgrowing the caches add up to about half an order to the time, which is tolerated,
+// while anything quadratic is still caught. Allocations are counted exactly.
+constexpr double TIME_TOLERANCE  = 0.6;
+constexpr double ALLOC_TOLERANCE = 0.2;
+
+std::vector<std::string> g_arguments;
+std::vector<char*> g_argv;
+
+void setArguments(const std::vector<std::string>& args)
+{
+	g_arguments = args;
+	g_argv.clear();
+
+	for (std::string& arg : g_arguments)
+		g_argv.push_back(&arg[0]);
+
+	g_argv.push_back(nullptr);
+}
+
+std::string optionName(const size_t& i)
+{
+	return "--option-" + std::to_string(i);
+}
+
+// Of the same length for all i, so the size of the reported messages does not depend on n
+std::string unknownName(const size_t& i)
+{
+	const std::string digits = std::to_string(i);
+	return "--unknown-" + std::string(digits.size() < 8 ? 8 - digits.size() : 0, '0') + digits;
+}
+
+// Options sharing long common prefixes, so lookups cannot decide early on the first characters
+CommandLineOption makeOption(const size_t& i, const CLO::HasValue& hasValue = CLO::HasValue::Yes, const CLO::Required& required = CLO::Required::No)
+{
+	return CommandLineOption("-" + std::to_string(i), optionName(i), "Option " + std::to_string(i), hasValue, required);
+}
+
+std::unique_ptr<CommandLineParser> makeParser(const size_t& options, const CLO::HasValue& hasValue = CLO::HasValue::Yes, const CLO::Required& required = CLO::Required::No)
+{
+	std::unique_ptr<CommandLineParser> pParser(new CommandLineParser(0, nullptr));
+
+	for (size_t i = 0; i < options; i++)
+		pParser->addOption(makeOption(i, hasValue, required));
+
+	return pParser;
+}
+
+std::string writeFile(const std::string& name, const std::string& content)
+{
+	const std::string path = "complexity_" + name + ".tmp";
+	std::ofstream file(path, std::ios::binary);
+	file << content;
+	return path;
+}
+
+std::vector<Case> makeCases()
+{
+	std::vector<Case> cases;
+
+	cases.push_back({ "addOption", 1.0, [](const size_t& n) {
+						 return [n]() { makeParser(n); };
+					 } });
+
+	// The arguments are given in reverse order of the options
+	cases.push_back({ "match", 1.0, [](const size_t& n) {
+						 std::vector<std::string> args = { "prog" };
+
+						 for (size_t i = 0; i < n; i++)
+							 args.insert(args.end(), { optionName(n - 1 - i), std::to_string(i) });
+
+						 std::shared_ptr<std::vector<std::string>> pArgs(new std::vector<std::string>(args));
+
+						 return [n, pArgs]() {
+							 setArguments(*pArgs);
+							 CommandLineParser parser(static_cast<int>(g_argv.size() - 1), g_argv.data());
+
+							 for (size_t i = 0; i < n; i++)
+								 parser.addOption(makeOption(i));
+
+							 parser.tryParse();
+						 };
+					 } });
+
+	// Every argument is unknown and reported with its offset in the command line
+	cases.push_back({ "match-unknown", 1.0, [](const size_t& n) {
+						 std::vector<std::string> args = { "prog" };
+
+						 for (size_t i = 0; i < n; i++)
+							 args.push_back(unknownName(i));
+
+						 std::shared_ptr<std::vector<std::string>> pArgs(new std::vector<std::string>(args));
+
+						 return [pArgs]() {
+							 setArguments(*pArgs);
+							 CommandLineParser parser(static_cast<int>(g_argv.size() - 1), g_argv.data());
+							 parser.addOption(CommandLineOption("-o", "--option", "", CLO::HasValue::Yes));
+							 parser.tryParse();
+						 };
+					 } });
+
+	// Only the first occurrence is used, all others have to be skipped cheaply
+	cases.push_back({ "match-duplicate", 1.0, [](const size_t& n) {
+						 std::vector<std::string> args = { "prog" };
+
+						 for (size_t i = 0; i < n; i++)
+							 args.insert(args.end(), { "--option", std::to_string(i) });
+
+						 std::shared_ptr<std::vector<std::string>> pArgs(new std::vector<std::string>(args));
+
+						 return [pArgs]() {
+							 setArguments(*pArgs);
+							 CommandLineParser parser(static_cast<int>(g_argv.size() - 1), g_argv.data());
+							 parser.addOption(CommandLineOption("-o", "--option", "", CLO::HasValue::Yes));
+							 parser.tryParse();
+						 };
+					 } });
+
+	// Same as match-unknown for a result, the parser only serves as schema
+	cases.push_back({ "parseInto-unknown", 1.0, [](const size_t& n) {
+						 std::vector<std::string> args = { "prog" };
+
+						 for (size_t i = 0; i < n; i++)
+							 args.push_back(unknownName(i));
+
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(1));
+						 std::shared_ptr<std::vector<std::string>> pArgs(new std::vector<std::string>(args));
+
+						 return [pParser, pArgs]() {
+							 setArguments(*pArgs);
+							 CommandLineParser::Result result;
+							 pParser->parseInto(static_cast<int>(g_argv.size() - 1), g_argv.data(), result);
+						 };
+					 } });
+
+	// Every option is set once in reverse order, followed by a repetition of all of them
+	cases.push_back({ "parseInto-set", 1.0, [](const size_t& n) {
+						 std::vector<std::string> args = { "prog" };
+
+						 for (size_t r = 0; r < 2; r++)
+						 {
+							 for (size_t i = 0; i < n; i++)
+								 args.insert(args.end(), { optionName(n - 1 - i), std::to_string(i) });
+						 }
+
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(n));
+						 std::shared_ptr<std::vector<std::string>> pArgs(new std::vector<std::string>(args));
+
+						 return [pParser, pArgs]() {
+							 setArguments(*pArgs);
+							 CommandLineParser::Result result;
+							 pParser->parseInto(static_cast<int>(g_argv.size() - 1), g_argv.data(), result);
+						 };
+					 } });
+
+	// A command line string from an untrusted source, parsed on a miss and compared on the hit
+	cases.push_back({ "resultCache", 1.0, [](const size_t& n) {
+						 std::string cmdline = "prog";
+
+						 for (size_t i = 0; i < n; i++)
+							 cmdline.append(" ").append(i % 2 ? unknownName(i) : "'" + optionName(0) + "'");
+
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(1));
+
+						 return [pParser, cmdline]() {
+							 CommandLineResultCache cache(*pParser, 1, 1);
+							 cache.parse(cmdline);
+							 cache.parse(cmdline);
+						 };
+					 } });
+
+	cases.push_back({ "verify-required", 1.0, [](const size_t& n) {
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(n, CLO::HasValue::Yes, CLO::Required::Yes));
+
+						 return [pParser]() {
+							 pParser->reset();
+							 pParser->verify();
+						 };
+					 } });
+
+	// Every lookup goes through the name index
+	cases.push_back({ "getValue", 1.0, [](const size_t& n) {
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(n));
+						 std::shared_ptr<std::vector<CommandLineOption>> pOptions(new std::vector<CommandLineOption>());
+
+						 for (size_t i = 0; i < n; i++)
+							 pOptions->push_back(makeOption(i));
+
+						 return [pParser, pOptions]() {
+							 for (const CommandLineOption& option : *pOptions)
+							 {
+								 pParser->isSet(option);
+								 pParser->getValue(option);
+							 }
+						 };
+					 } });
+
+	// Many short words and a single word longer than the line
+	cases.push_back({ "help-words", 1.0, [](const size_t& n) {
+						 std::string desc;
+
+						 for (size_t i = 0; i < n; i++)
+							 desc.append("word ");
+
+						 std::shared_ptr<CommandLineOption> pOption(new CommandLineOption("-o", "--option", desc, CLO::HasValue::Yes));
+
+						 return [pOption]() {
+							 std::ostringstream os;
+							 os << *pOption;
+						 };
+					 } });
+
+	cases.push_back({ "help-long-word", 1.0, [](const size_t& n) {
+						 std::shared_ptr<CommandLineOption> pOption(new CommandLineOption("-o", "--option", "a " + std::string(n * 4, 'x') + " b", CLO::HasValue::Yes));
+
+						 return [pOption]() {
+							 std::ostringstream os;
+							 os << *pOption;
+						 };
+					 } });
+
+	cases.push_back({ "loadCommandLine", 1.0, [](const size_t& n) {
+						 std::string cmdline = "prog";
+
+						 for (size_t i = 0; i < n; i++)
+							 cmdline.append(i % 3 ? " 'quoted arg'" : " \"esc\\\"aped\"").append(" plain");
+
+						 std::shared_ptr<CommandLineParser> pParser(new CommandLineParser(0, nullptr));
+
+						 return [pParser, cmdline]() { pParser->loadCommandLine(cmdline); };
+					 } });
+
+	cases.push_back({ "csv-views", 1.0, [](const size_t& n) {
+						 std::string value;
+
+						 for (size_t i = 0; i < n; i++)
+							 value.append(i ? "," : "").append(i % 2 ? "\"a\"\"b\"" : "\"c,d\"");
+
+						 std::shared_ptr<CommandLineParser> pParser(new CommandLineParser(0, nullptr));
+						 std::shared_ptr<CommandLineOption> pOption(new CommandLineOption("-l", "--list", "", CLO::HasValue::Yes));
+						 pParser->addOption(*pOption);
+						 pParser->loadCommandLine("prog --list '" + value + "'");
+						 pParser->tryParse();
+
+						 return [pParser, pOption]() { pParser->getValueViews(*pOption); };
+					 } });
+
+	cases.push_back({ "loadConfig", 1.0, [](const size_t& n) {
+						 std::string content;
+
+						 for (size_t i = 0; i < n; i++)
+							 content.append("# comment\n").append(optionName(i).substr(2)).append(" = ").append(std::to_string(i)).append("\n");
+
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(n));
+						 const std::string path = writeFile("config", content);
+
+						 return [pParser, path]() {
+							 pParser->reset();
+							 pParser->loadConfig(path);
+						 };
+					 } });
+
+	// Each value refers to the previous option, the chain exceeds the maximum depth of references
+	// for larger n, which has to be reported instead of exhausting the stack
+	cases.push_back({ "interpolation-chain", 1.0, [](const size_t& n) {
+						 std::shared_ptr<CommandLineParser> pParser(makeParser(n));
+						 std::string cmdline = "prog " + optionName(0) + " x";
+
+						 for (size_t i = 1; i < n; i++)
+							 cmdline.append(" " + optionName(i) + " a${opt:" + optionName(i - 1) + "}");
+
+						 std::shared_ptr<CommandLineOption> pLast(new CommandLineOption(makeOption(n - 1)));
+						 pParser->setInterpolation(true);
+
+						 return [pParser, pLast, cmdline]() {
+							 pParser->reset();
+							 pParser->loadCommandLine(cmdline);
+							 pParser->match();
+							 pParser->getValue(*pLast);
+						 };
+					 } });
+
+	return cases;
+}
+
+Sample measure(const Case& testCase, const size_t& n, const size_t& repeats)
+{
+	const Operation operation = testCase.setup(n);
+	Sample sample             = { n, 0.0, 0 };
+
+	for (size_t r = 0; r < repeats; r++)
+	{
+		const uint64_t allocations   = g_allocations.load(std::memory_order_relaxed);
+		const Clock::time_point start = Clock::now();
+		operation();
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		sample.allocations = g_allocations.load(std::memory_order_relaxed) - allocations;
+
+		if (r == 0 || seconds < sample.seconds)
+			sample.seconds = seconds;
+	}
+
+	return sample;
+}
+
+double exponent(const double& small, const double& large)
+{
+	return std::log2((std::max)(large, 1e-9) / (std::max)(small, 1e-9));
+}
+
+// Prints the samples of a case and returns false if it grows faster than declared. The growth is
+// fitted over the upper half of the sizes, as the smallest sizes are dominated by constant costs
+// and single doublings are subject to measurement noise.
+bool report(const Case& testCase, const std::vector<Sample>& samples)
+{
+	std::cout << testCase.name << " (bound n^" << testCase.bound << ")" << std::endl;
+
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		std::cout << "  n = " << std::setw(7) << samples[i].n << std::setw(14) << std::fixed << std::setprecision(1) << samples[i].seconds * 1e6 << " us" << std::setw(12) << samples[i].allocations << " allocs";
+
+		if (i > 0)
+		{
+			const double time  = exponent(samples[i - 1].seconds, samples[i].seconds);
+			const double alloc = exponent(static_cast<double>(samples[i - 1].allocations), static_cast<double>(samples[i].allocations));
+			std::cout << std::setprecision(2) << "   growth time " << std::setw(5) << time << ", allocs " << std::setw(5) << alloc;
+		}
+
+		std::cout << std::endl;
+	}
+
+	std::cout.unsetf(std::ios::floatfield);
+
+	const Sample& mid   = samples[(samples.size() - 1) / 2];
+	const Sample& last  = samples.back();
+	const double steps  = std::log2(static_cast<double>(last.n) / static_cast<double>(mid.n));
+	const double time   = exponent(mid.seconds, last.seconds) / steps;
+	const double alloc  = exponent(static_cast<double>(mid.allocations), static_cast<double>(last.allocations)) / steps;
+	const bool timeOk   = time <= testCase.bound + TIME_TOLERANCE;
+	const bool allocOk  = alloc <= testCase.bound + ALLOC_TOLERANCE;
+
+	std::cout << "  fitted growth: time n^" << time << ", allocs n^" << alloc << std::endl;
+
+	if (!timeOk)
+		std::cout << "  EXCEEDED: time grows faster than n^" << testCase.bound << std::endl;
+
+	if (!allocOk)
+		std::cout << "  EXCEEDED: allocations grow faster than n^" << testCase.bound << std::endl;
+
+	return timeOk && allocOk;
+}
+
+std::string randomToken(std::mt19937& rng, const std::vector<std::string>& names)
+{
+	static const char* const SPECIAL[] = { "", "-", "--", "---", "-=", "--=", "=", " ", "\t", "'", "\"", "\\", "${", "${opt:", "$$", "\xff\xfe", "-1", "1e999", "0x", "nan", ",,,", "\"a\"\"b\"" };
+	std::uniform_int_distribution<size_t> kind(0, 9);
+
+	switch (kind(rng))
+	{
+		case 0:
+		case 1:
+		case 2:
+		case 3:
+			return names[rng() % names.size()];
+		case 4:
+			return names[rng() % names.size()] + "=" + std::to_string(rng() % 100);
+		case 5:
+			return SPECIAL[rng() % (sizeof(SPECIAL) / sizeof(SPECIAL[0]))];
+		default:
+		{
+			std::string token(rng() % 12, ' ');
+
+			for (char& c : token)
+				c = static_cast<char>(rng() % 95 + 32);
+
+			return token;
+		}
+	}
+}
+
+// Parses random schemas and command lines and checks that the reported diagnostics are consistent
+// and that parseInto yields the same values as match
+bool fuzz(const size_t& iterations, const uint32_t& seed)
+{
+	std::mt19937 rng(seed);
+	size_t failures = 0;
+
+	for (size_t it = 0; it < iterations; it++)
+	{
+		std::vector<std::string> names;
+		std::vector<CommandLineOption> options;
+		const size_t count = rng() % 16 + 1;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const std::string arg    = "-" + std::string(1, static_cast<char>('a' + i));
+			const std::string argAlt = "--" + std::string(rng() % 3 + 1, static_cast<char>('a' + i));
+			options.push_back(CommandLineOption(arg, argAlt, "Fuzz", rng() % 2 ? CLO::HasValue::Yes : CLO::HasValue::No, rng() % 4 ? CLO::Required::No : CLO::Required::Yes));
+
+			if (options.back().hasValue() && rng() % 3 == 0)
+				options.back().setArgCount(rng() % 3 + 1);
+
+			names.insert(names.end(), { arg, argAlt });
+		}
+
+		std::vector<std::string> args = { "prog" };
+		const size_t argc             = rng() % 24;
+
+		for (size_t i = 0; i < argc; i++)
+			args.push_back(randomToken(rng, names));
+
+		setArguments(args);
+		CommandLineParser parser(static_cast<int>(g_argv.size() - 1), g_argv.data());
+
+		for (const CommandLineOption& option : options)
+			parser.addOption(option);
+
+		const bool interpolation = rng() % 2 == 0;
+		parser.setInterpolation(interpolation);
+
+		// The same arguments parsed into a result, which uses the parser only as schema
+		CommandLineParser schema(0, nullptr);
+		CommandLineParser::Result result;
+
+		for (const CommandLineOption& option : options)
+			schema.addOption(option);
+
+		schema.parseInto(static_cast<int>(g_argv.size() - 1), g_argv.data(), result);
+
+		// Missing values are marked right after the last argument
+		size_t length = 0;
+
+		for (const std::string& arg : args)
+			length += arg.size() + 1;
+
+		std::string error;
+		const bool valid = parser.tryParse();
+
+		if (valid != parser.getDiagnostics().empty())
+			error = "tryParse result does not match the diagnostics";
+
+		for (const CommandLineParser::Diagnostic& diag : parser.getDiagnostics())
+		{
+			if (diag.token < -1 || diag.token >= static_cast<int>(args.size()))
+				error = "diagnostic refers to token " + std::to_string(diag.token);
+			else if (diag.token >= 0 && diag.offset + diag.length > length + 1)
+				error = "diagnostic span exceeds the command line";
+			else if (diag.message.empty())
+				error = "diagnostic without message";
+		}
+
+		for (const CommandLineOption& option : options)
+		{
+			if (!parser.isSet(option) && parser.getValue(option) != option.getDefault())
+				error = "unset option " + option.getArgAltName() + " has a value";
+			else if (result.isSet(option) != parser.isSet(option) || (!interpolation && result.getValue(option) != parser.getValue(option)))
+				error = "parseInto and match disagree on option " + option.getArgAltName();
+			else if (option.hasValue())
+				parser.getValueViews(option);
+		}
+
+		if (result.getUnknown().size() != parser.getUnknownOptions().size())
+			error = "parseInto and match disagree on the unknown options";
+
+		if (error.empty())
+			continue;
+
+		failures++;
+		std::cout << "FUZZ FAILURE (seed " << seed << ", iteration " << it << "): " << error << std::endl << " ";
+
+		for (const std::string& arg : args)
+			std::cout << " [" << arg << "]";
+
+		std::cout << std::endl;
+	}
+
+	std::cout << "fuzz: " << iterations << " iterations, " << failures << " failure(s)" << std::endl;
+
+	return failures == 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	CommandLineParser clp(argc, argv);
+
+	const CommandLineOption quickOpt("-q", "--quick", "Smaller sizes and fewer repetitions, e.g., for CI", CLO::HasValue::No);
+	const CommandLineOption caseOpt("-c", "--case", "Only run the case with the given name", CLO::HasValue::Yes);
+	const CommandLineOption fuzzOpt("-f", "--fuzz", "Number of fuzzing iterations", "20000");
+	const CommandLineOption seedOpt("-s", "--seed", "Seed of the fuzzer", "1");
+
+	clp.addOption(quickOpt);
+	clp.addOption(caseOpt);
+	clp.addOption(fuzzOpt);
+	clp.addOption(seedOpt);
+	clp.addHelpOption();
+	clp.parse(false);
+
+	const bool quick     = clp.isSet(quickOpt);
+	const size_t first   = quick ? 512 : 1024;
+	const size_t steps   = quick ? 4 : 6;
+	const size_t repeats = quick ? 3 : 7;
+	bool success         = true;
+
+	for (const Case& testCase : makeCases())
+	{
+		if (clp.isSet(caseOpt) && clp.getValue(caseOpt) != testCase.name)
+			continue;
+
+		// A case exceeding its bound is measured again, so a single disturbance does not fail it
+		bool passed = false;
+
+		for (size_t attempt = 0; attempt < 2 && !passed; attempt++)
+		{
+			std::vector<Sample> samples;
+
+			for (size_t i = 0, n = first; i < steps; i++, n *= 2)
+				samples.push_back(measure(testCase, n, repeats));
+
+			passed = report(testCase, samples);
+		}
+
+		success &= passed;
+	}
+
+	std::remove("complexity_config.tmp");
+
+	success &= fuzz(clp.getValueAs<size_t>(fuzzOpt) / (quick ? 10 : 1), clp.getValueAs<uint32_t>(seedOpt));
+
+	return success ? 0 : 1;
+}
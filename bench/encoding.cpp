@@ -0,0 +1,217 @@
+/*
+ *  File: encoding.cpp
+ *  Copyright (c) 2023 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+// Known-answer tests of the hex and base64 decoders
+// Checks the test vectors of RFC 4648 and the padding rules, and round trips random bytes of
+// all lengths up to several times the 16 characters decoded at once by the SSE2 path of hex,
+// once unmodified, once with an odd length and with each of a set of invalid characters at each
+// position.
+
+#include "CommandLineParser.h"
+
+#include <random>
+
+namespace
+{
+using Bytes = std::vector<std::byte>;
+
+// Beyond a few blocks of 16 characters of the SSE2 path, including all remainders
+constexpr size_t MAX_LENGTH = 80;
+
+size_t g_failures = 0;
+
+void check(const bool& condition, const std::string& what)
+{
+	if (condition)
+		return;
+
+	g_failures++;
+	std::cout << "FAILURE: " << what << std::endl;
+}
+
+Bytes toBytes(const std::string& str)
+{
+	Bytes bytes;
+
+	for (const char& c : str)
+		bytes.push_back(static_cast<std::byte>(c));
+
+	return bytes;
+}
+
+// Reference encoders, written independently of the decoders
+std::string encodeHex(const Bytes& bytes, std::mt19937& rng)
+{
+	static const char LOWER[] = "0123456789abcdef";
+	static const char UPPER[] = "0123456789ABCDEF";
+	std::string str;
+
+	for (const std::byte& b : bytes)
+	{
+		const char* pDigits = rng() % 2 ? LOWER : UPPER;
+		str.append(1, pDigits[static_cast<uint8_t>(b) >> 4]).append(1, pDigits[static_cast<uint8_t>(b) & 0xF]);
+	}
+
+	return str;
+}
+
+std::string encodeBase64(const Bytes& bytes, const bool& padding)
+{
+	static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string str;
+
+	for (size_t i = 0; i < bytes.size(); i += 3)
+	{
+		const size_t count = (std::min)(static_cast<size_t>(3), bytes.size() - i);
+		uint32_t value     = 0;
+
+		for (size_t j = 0; j < 3; j++)
+			value = (value << 8) | (j < count ? static_cast<uint32_t>(bytes[i + j]) : 0);
+
+		for (size_t j = 0; j < count + 1; j++)
+			str.push_back(ALPHABET[(value >> (18 - 6 * j)) & 0x3F]);
+
+		if (padding)
+			str.append(3 - count, '=');
+	}
+
+	return str;
+}
+
+void testVectors()
+{
+	// RFC 4648, section 10
+	static const std::pair<const char*, const char*> BASE64[] = {
+		{ "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" }, { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" }
+	};
+
+	static const std::pair<const char*, const char*> BASE16[] = {
+		{ "", "" }, { "f", "66" }, { "fo", "666F" }, { "foo", "666F6F" }, { "foob", "666F6F62" }, { "fooba", "666F6F6261" }, { "foobar", "666F6F626172" }
+	};
+
+	Bytes out;
+
+	for (const std::pair<const char*, const char*>& vector : BASE64)
+	{
+		std::string unpadded = vector.second;
+		unpadded.erase(std::find(unpadded.begin(), unpadded.end(), '='), unpadded.end());
+
+		check(CommandLineEncoding::decodeBase64(vector.second, out) && out == toBytes(vector.first), std::string("base64 \"") + vector.second + "\"");
+		check(CommandLineEncoding::decodeBase64(unpadded, out) && out == toBytes(vector.first), "base64 without padding \"" + unpadded + "\"");
+	}
+
+	for (const std::pair<const char*, const char*>& vector : BASE16)
+	{
+		std::string lower = vector.second;
+		std::transform(lower.begin(), lower.end(), lower.begin(), [](const char& c) { return static_cast<char>(std::tolower(c)); });
+
+		check(CommandLineEncoding::decodeHex(vector.second, out) && out == toBytes(vector.first), std::string("hex \"") + vector.second + "\"");
+		check(CommandLineEncoding::decodeHex(lower, out) && out == toBytes(vector.first), "hex \"" + lower + "\"");
+	}
+
+	// Padding only at the end, only up to a multiple of 4 and never more than two characters
+	static const char* const INVALID_BASE64[] = {
+		"=", "==", "===", "====", "Zg=", "Zg===", "Z===", "Zm9v=", "Zm9v==", "Zm8==", "Z", "Zm9vY", "Zg==Zg==", "Z=g=", "=Zg=", "Zm 9v", "Zm9v\n", " Zm9v", "Zm9-", "Zm9_", "Zm9v\xff"
+	};
+
+	for (const char* pCase : INVALID_BASE64)
+		check(!CommandLineEncoding::decodeBase64(pCase, out), std::string("invalid base64 \"") + pCase + "\" is accepted");
+
+	static const char* const INVALID_HEX[] = { "0", "000", "0g", "g0", "0x00", " 00", "00 ", "0\xff", "\xff" "0" };
+
+	for (const char* pCase : INVALID_HEX)
+		check(!CommandLineEncoding::decodeHex(pCase, out), std::string("invalid hex \"") + pCase + "\" is accepted");
+}
+
+// Characters next to the valid ranges, with the high bit set, which the SSE2 path compares as signed,
+// and the null character. '=' is checked separately, as it may turn base64 into shorter valid base64.
+const std::string HIGH_CHARS     = std::string(1, '\0') + " \n\x80\xb0\xc1\xe6\xff";
+const std::string HEX_INVALID    = "/:@G`g" + HIGH_CHARS;
+const std::string BASE64_INVALID = "*,-.:@[`{_" + HIGH_CHARS;
+
+void testRoundTrips(const uint32_t& seed)
+{
+	std::mt19937 rng(seed);
+	Bytes out;
+
+	for (size_t length = 0; length <= MAX_LENGTH; length++)
+	{
+		Bytes bytes(length);
+
+		for (std::byte& b : bytes)
+			b = static_cast<std::byte>(rng() & 0xFF);
+
+		const std::string hex = encodeHex(bytes, rng);
+		const std::string len = std::to_string(length);
+
+		check(CommandLineEncoding::decodeHex(hex, out) && out == bytes, "hex round trip of " + len + " bytes");
+		check(!CommandLineEncoding::decodeHex(hex + "0", out), "hex of odd length " + std::to_string(hex.size() + 1) + " is accepted");
+
+		for (size_t pos = 0; pos < hex.size(); pos++)
+		{
+			for (const char& c : HEX_INVALID)
+			{
+				std::string invalid = hex;
+				invalid[pos]        = c;
+
+				check(!CommandLineEncoding::decodeHex(invalid, out), "hex of " + len + " bytes with the invalid character " + std::to_string(static_cast<uint8_t>(c)) + " at " + std::to_string(pos) + " is accepted");
+			}
+		}
+
+		for (const bool& padding : { true, false })
+		{
+			const std::string base64 = encodeBase64(bytes, padding);
+
+			check(CommandLineEncoding::decodeBase64(base64, out) && out == bytes, "base64 round trip of " + len + " bytes" + (padding ? "" : " without padding"));
+
+			for (size_t pos = 0; pos < base64.size(); pos++)
+			{
+				for (const char& c : BASE64_INVALID)
+				{
+					std::string invalid = base64;
+					invalid[pos]        = c;
+
+					check(!CommandLineEncoding::decodeBase64(invalid, out), "base64 of " + len + " bytes with the invalid character " + std::to_string(static_cast<uint8_t>(c)) + " at " + std::to_string(pos) + " is accepted");
+				}
+			}
+		}
+	}
+
+	// A decoded value replaces the previous one of the same vector entirely
+	check(CommandLineEncoding::decodeHex(std::string(64, 'f'), out) && CommandLineEncoding::decodeHex("00", out) && out == Bytes(1, std::byte(0)), "hex decoded into a reused vector");
+	check(CommandLineEncoding::decodeBase64("Zm9vYmFy", out) && CommandLineEncoding::decodeBase64("Zg", out) && out == toBytes("f"), "base64 decoded into a reused vector");
+}
+} // namespace
+
+int main()
+{
+	testVectors();
+	testRoundTrips(1);
+
+	std::cout << "encoding: " << g_failures << " failure(s)" << std::endl;
+
+	return g_failures == 0 ? 0 : -1;
+}
@@ -0,0 +1,319 @@
+/*
+ *  File: network.cpp
+ *  Copyright (c) 2023 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+// Known-answer tests of the address, endpoint and network parsers
+// Addresses are compared against inet_pton, the reference for the textual forms of IPv4 and
+// IPv6 addresses, for a list of edge cases and for random, partly damaged, addresses.
+// Endpoints, networks and lists are checked against fixed expectations.
+//
+// Usage: network [--fuzz <iterations>] [--seed <seed>]
+
+#include "CommandLineParser.h"
+
+#include <random>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+namespace
+{
+using Net = CommandLineNetwork;
+
+size_t g_failures = 0;
+
+void check(const bool& condition, const std::string& what)
+{
+	if (condition)
+		return;
+
+	g_failures++;
+	std::cout << "FAILURE: " << what << std::endl;
+}
+
+std::string hexBytes(const uint8_t* pBytes, const size_t& count)
+{
+	static const char HEX[] = "0123456789abcdef";
+	std::string str;
+
+	for (size_t i = 0; i < count; i++)
+		str.append(1, HEX[pBytes[i] >> 4]).append(1, HEX[pBytes[i] & 0xF]);
+
+	return str;
+}
+
+// The textual form is IPv6 if it contains a colon, the same decision as CommandLineNetwork::parse
+void compareAddress(const std::string& str)
+{
+	uint8_t expected[16] = {};
+	const int family     = str.find(':') != std::string::npos ? AF_INET6 : AF_INET;
+	const bool valid     = inet_pton(family, str.c_str(), expected) == 1;
+	const size_t size    = family == AF_INET6 ? 16 : 4;
+
+	Net::Address address;
+	const bool parsed = Net::parse(str, address);
+
+	if (parsed != valid)
+		check(false, "address \"" + str + "\" is " + (parsed ? "accepted" : "rejected") + ", inet_pton " + (valid ? "accepts" : "rejects") + " it");
+	else if (valid)
+	{
+		check(address.family == (family == AF_INET6 ? 6 : 4), "address \"" + str + "\" has family " + std::to_string(address.family));
+		check(std::memcmp(address.bytes, expected, size) == 0, "address \"" + str + "\" is " + hexBytes(address.bytes, size) + ", inet_pton " + hexBytes(expected, size));
+	}
+}
+
+std::string randomNumber(std::mt19937& rng, const bool& hex)
+{
+	const unsigned value = hex ? rng() % 0x1FFFF : rng() % 300;
+	std::ostringstream ss;
+
+	// Occasionally with leading zeros or, for hex, too many digits
+	ss << std::string(rng() % 8 == 0 ? rng() % 3 : 0, '0');
+
+	if (hex)
+		ss << std::hex << std::uppercase << (rng() % 8 == 0 ? value : value & 0xFFFF);
+	else
+		ss << value;
+
+	std::string str = ss.str();
+
+	if (hex && rng() % 2)
+		std::transform(str.begin(), str.end(), str.begin(), [](const char& c) { return static_cast<char>(std::tolower(c)); });
+
+	return str;
+}
+
+// An IPv4 or IPv6 address built from random groups, possibly with a gap or an embedded IPv4
+// address and possibly damaged by a few random edits, so valid and invalid addresses are frequent
+std::string randomAddress(std::mt19937& rng)
+{
+	static const char ALPHABET[] = "0123456789abcdefABCDEFg:.";
+	std::string str;
+
+	if (rng() % 3 == 0)
+	{
+		for (size_t i = 0, count = rng() % 8 == 0 ? rng() % 6 : 4; i < count; i++)
+			str.append(i ? "." : "").append(randomNumber(rng, false));
+	}
+	else
+	{
+		const size_t count = rng() % 10;
+		const size_t gap   = rng() % 2 ? rng() % (count + 1) : count + 1;
+
+		for (size_t i = 0; i < count; i++)
+			str.append(i == gap ? "::" : i ? ":" : "").append(randomNumber(rng, true));
+
+		if (gap == count)
+			str.append("::");
+
+		if (rng() % 4 == 0)
+		{
+			const std::string first = std::to_string(rng() % 256);
+			const std::string last  = std::to_string(rng() % 300);
+			str.append(str.empty() || str.back() == ':' ? "" : ":").append(first + ".1.2." + last);
+		}
+	}
+
+	for (size_t i = 0, edits = rng() % 2 ? rng() % 3 : 0; i < edits; i++)
+	{
+		const size_t pos = str.empty() ? 0 : rng() % str.size();
+		const char c     = ALPHABET[rng() % (sizeof(ALPHABET) - 1)];
+
+		if (rng() % 3 == 0 || str.empty())
+			str.insert(str.begin() + static_cast<std::ptrdiff_t>(pos), c);
+		else if (rng() % 2)
+			str[pos] = c;
+		else
+			str.erase(pos, 1);
+	}
+
+	return str;
+}
+
+void testAddresses(const size_t& iterations, const uint32_t& seed)
+{
+	static const char* const CASES[] = {
+		"0.0.0.0", "255.255.255.255", "1.2.3.4", "127.0.0.1", "256.1.1.1", "1.2.3", "1.2.3.4.5", "1..2.3", ".1.2.3", "1.2.3.", "01.2.3.4",
+		"1.2.3.04", "1.2.3.0", "1.2.3.4 ", " 1.2.3.4", "1.2.3.-4", "1.2.3.1000", "", ".", "a.b.c.d", "0x1.2.3.4",
+
+		"::", "::1", "1::", "::0:0", "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7::", "::2:3:4:5:6:7:8", "1::8", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7",
+		"1::2::3", ":::", ":1::", "1:::2", "1:", ":1", "1:2:3:4:5:6:7:8::", "::1:2:3:4:5:6:7:8", "12345::", "g::", "fffff::", "FFFF::ffff",
+		"2001:db8::ff00:42:8329", "2001:DB8:0:0:8:800:200C:417A", "fe80::1%eth0", "::ffff:1.2.3.4", "::1.2.3.4", "1:2:3:4:5:6:1.2.3.4",
+		"1:2:3:4:5:6:7:1.2.3.4", "1:2:3:4:5::1.2.3.4", "::1.2.3", "::1.2.3.4.5", "::256.1.1.1", "1.2.3.4::", "::1.2.3.4:1", "::01.2.3.4",
+		"1:2:3:4:5:6::1.2.3.4", "0:0:0:0:0:0:0:0", "::0001", "::00001", ":", "1:2:3:4:5:6:7:8:", ":1:2:3:4:5:6:7:8"
+	};
+
+	for (const char* pCase : CASES)
+		compareAddress(pCase);
+
+	std::mt19937 rng(seed);
+
+	for (size_t i = 0; i < iterations; i++)
+		compareAddress(randomAddress(rng));
+}
+
+void testEndpoints()
+{
+	struct Case
+	{
+		const char* str;
+		bool valid;
+		uint8_t family;
+		const char* host;
+		uint16_t port;
+	};
+
+	static const Case CASES[] = {
+		{ "1.2.3.4:80", true, 4, "", 80 },
+		{ "[::1]:22", true, 6, "", 22 },
+		{ "host.example.com:443", true, 0, "host.example.com", 443 },
+		{ "localhost:0", true, 0, "localhost", 0 },
+		{ "db-1:65535", true, 0, "db-1", 65535 },
+		{ "1host:1", true, 0, "1host", 1 },
+		{ "web-1.2a:8", true, 0, "web-1.2a", 8 },
+		{ "host:65536", false, 0, "", 0 },
+		{ "host:", false, 0, "", 0 },
+		{ "host", false, 0, "", 0 },
+		{ ":80", false, 0, "", 0 },
+		{ "host:-1", false, 0, "", 0 },
+		{ "host:123456", false, 0, "", 0 },
+		{ "::1:22", false, 0, "", 0 },
+		{ "[::1]22", false, 0, "", 0 },
+		{ "[::1]", false, 0, "", 0 },
+		{ "[1.2.3.4]:80", false, 0, "", 0 },
+		{ "999.1.1.1:80", false, 0, "", 0 },
+		{ "1.2.3:80", false, 0, "", 0 },
+		{ "123:1", false, 0, "", 0 },
+		{ "a.123:1", false, 0, "", 0 },
+		{ "-host:1", false, 0, "", 0 },
+		{ "host-:1", false, 0, "", 0 },
+		{ "ho_st:1", false, 0, "", 0 },
+		{ "a..b:1", false, 0, "", 0 },
+	};
+
+	for (const Case& c : CASES)
+	{
+		Net::Endpoint endpoint;
+		const bool valid = Net::parse(c.str, endpoint);
+
+		check(valid == c.valid, std::string("endpoint \"") + c.str + "\" is " + (valid ? "accepted" : "rejected"));
+
+		if (valid && c.valid)
+		{
+			check(endpoint.address.family == c.family, std::string("endpoint \"") + c.str + "\" has family " + std::to_string(endpoint.address.family));
+			check(endpoint.host == c.host, std::string("endpoint \"") + c.str + "\" has host \"" + std::string(endpoint.host) + "\"");
+			check(endpoint.port == c.port, std::string("endpoint \"") + c.str + "\" has port " + std::to_string(endpoint.port));
+		}
+	}
+
+	// A host name label has at most 63 characters
+	Net::Endpoint endpoint;
+	check(Net::parse(std::string(63, 'a') + ".com:1", endpoint), "host name with a label of 63 characters is rejected");
+	check(!Net::parse(std::string(64, 'a') + ".com:1", endpoint), "host name with a label of 64 characters is accepted");
+}
+
+void testNetworks()
+{
+	struct Case
+	{
+		const char* str;
+		bool valid;
+		uint8_t prefix;
+	};
+
+	static const Case CASES[] = {
+		{ "10.0.0.0/8", true, 8 },
+		{ "10.0.0.1", true, 32 },
+		{ "0.0.0.0/0", true, 0 },
+		{ "1.2.3.4/32", true, 32 },
+		{ "1.2.3.4/33", false, 0 },
+		{ "::/0", true, 0 },
+		{ "2001:db8::/32", true, 32 },
+		{ "::1", true, 128 },
+		{ "::1/128", true, 128 },
+		{ "::1/129", false, 0 },
+		{ "1.2.3.4/", false, 0 },
+		{ "1.2.3.4/0008", false, 0 },
+		{ "1.2.3.4/-1", false, 0 },
+		{ "1.2.3.4/a", false, 0 },
+		{ "/8", false, 0 },
+		{ "1.2.3.4/8/8", false, 0 },
+	};
+
+	for (const Case& c : CASES)
+	{
+		Net::Network network;
+		const bool valid = Net::parse(c.str, network);
+
+		check(valid == c.valid, std::string("network \"") + c.str + "\" is " + (valid ? "accepted" : "rejected"));
+
+		if (valid && c.valid)
+			check(network.prefix == c.prefix, std::string("network \"") + c.str + "\" has prefix " + std::to_string(network.prefix));
+	}
+}
+
+void testLists()
+{
+	const Net::List<Net::Network> list = Net::parseList<Net::Network>(" 10.0.0.0/8 ,bad,, 192.168.1.1");
+
+	check(list.items.size() == 2, "list has " + std::to_string(list.items.size()) + " valid elements");
+	check(list.errors.size() == 2, "list has " + std::to_string(list.errors.size()) + " errors");
+
+	if (list.errors.size() == 2)
+	{
+		check(list.errors[0].index == 1 && list.errors[0].offset == 13, "first error at element " + std::to_string(list.errors[0].index) + ", offset " + std::to_string(list.errors[0].offset));
+		check(list.errors[1].index == 2 && list.errors[1].offset == 17, "second error at element " + std::to_string(list.errors[1].index) + ", offset " + std::to_string(list.errors[1].offset));
+	}
+
+	const Net::List<Net::Endpoint> endpoints = Net::parseList<Net::Endpoint>("a:1;[::1]:2", ';');
+	check(endpoints.items.size() == 2 && endpoints.errors.empty(), "list with custom delimiter is not parsed");
+	check(Net::parseList<Net::Address>("").errors.size() == 1, "empty list has no error for its single empty element");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	CommandLineParser clp(argc, argv);
+
+	const CommandLineOption fuzzOpt("-f", "--fuzz", "Number of random addresses compared against inet_pton", "200000");
+	const CommandLineOption seedOpt("-s", "--seed", "Seed of the random addresses", "1");
+
+	clp.addOption(fuzzOpt);
+	clp.addOption(seedOpt);
+	clp.addHelpOption();
+	clp.parse(false);
+
+	testAddresses(clp.getValueAs<size_t>(fuzzOpt), clp.getValueAs<uint32_t>(seedOpt));
+	testEndpoints();
+	testNetworks();
+	testLists();
+
+	std::cout << "network: " << g_failures << " failure(s)" << std::endl;
+
+	return g_failures == 0 ? 0 : -1;
+}
@@ -0,0 +1,232 @@
+/*
+ *  File: replay.cpp
+ *  Copyright (c) 2023 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+// Corpus-driven replay benchmark
+// Replays recorded command lines through the parser, single- and multi-threaded, and reports
+// latency percentiles per phase, allowing to check parser changes against real workloads.
+//
+// Usage: replay --corpus <file> --schema <file> [--threads <count>] [--iterations <count>]
+
+#include "CommandLineParser.h"
+
+// Measures the phases of parsing for each command line of the corpus, each worker thread uses its own parser
+class CommandLineReplay
+{
+public:
+	struct Percentiles
+	{
+		uint64_t p50;
+		uint64_t p99;
+		uint64_t p999;
+	};
+
+	// All latencies are given in nanoseconds per command line
+	struct Report
+	{
+		size_t commands;
+		size_t threads;
+		double seconds;
+		Percentiles tokenize;
+		Percentiles match;
+		Percentiles verify;
+		Percentiles total;
+	};
+
+public:
+	explicit CommandLineReplay(const std::vector<CommandLineOption>& options) :
+		m_options(options)
+	{
+	}
+
+	// Reads one command line per line, empty lines and lines starting with '#' are skipped
+	bool loadCorpus(const std::string& path)
+	{
+		std::ifstream file(path);
+		std::string line;
+
+		if (!file)
+			return false;
+
+		while (std::getline(file, line))
+		{
+			if (!line.empty() && line.front() != '#')
+				m_corpus.push_back(line);
+		}
+
+		return true;
+	}
+
+	void addCommandLine(const std::string& commandLine)
+	{
+		m_corpus.push_back(commandLine);
+	}
+
+	// Each option is described by one line: "<arg> <argAlt> <value|flag> [description]"
+	static std::vector<CommandLineOption> loadSchema(const std::string& path)
+	{
+		std::vector<CommandLineOption> options;
+		std::ifstream file(path);
+		std::string line;
+
+		while (std::getline(file, line))
+		{
+			std::istringstream ss(line);
+			std::string arg, argAlt, kind, desc;
+
+			if (line.empty() || line.front() == '#' || !(ss >> arg >> argAlt >> kind))
+				continue;
+
+			std::getline(ss >> std::ws, desc);
+			options.push_back(CommandLineOption(arg, argAlt, desc, kind == "flag" ? CLO::HasValue::No : CLO::HasValue::Yes));
+		}
+
+		return options;
+	}
+
+	Report run(const size_t& threads = 1, const size_t& iterations = 1) const
+	{
+		using Clock = std::chrono::steady_clock;
+
+		const size_t count   = m_corpus.size() * iterations;
+		const size_t workers = CommandLineWorkers::count(count, threads);
+		std::vector<std::unique_ptr<CommandLineParser>> parsers;
+		std::vector<uint64_t> tokenize(count), match(count), verify(count), total(count);
+
+		for (size_t i = 0; i < workers; i++)
+		{
+			parsers.emplace_back(new CommandLineParser(0, nullptr));
+
+			for (const CommandLineOption& option : m_options)
+				parsers.back()->addOption(option);
+		}
+
+		const Clock::time_point start = Clock::now();
+
+		CommandLineWorkers::forEach(count, workers, [&](const size_t& worker, const size_t& idx) {
+			CommandLineParser& parser = *parsers[worker];
+
+			// Resetting the options of the previous command line is proportional to the schema
+			// and not part of parsing a command line, therefore it is not measured
+			parser.reset();
+
+			const Clock::time_point t0 = Clock::now();
+			parser.loadCommandLine(m_corpus[idx % m_corpus.size()]);
+			const Clock::time_point t1 = Clock::now();
+			parser.match();
+			const Clock::time_point t2 = Clock::now();
+			parser.verify();
+			const Clock::time_point t3 = Clock::now();
+
+			tokenize[idx] = nanoseconds(t1 - t0);
+			match[idx]    = nanoseconds(t2 - t1);
+			verify[idx]   = nanoseconds(t3 - t2);
+			total[idx]    = nanoseconds(t3 - t0);
+		});
+
+		Report report;
+		report.commands = count;
+		report.threads  = workers;
+		report.seconds  = std::chrono::duration<double>(Clock::now() - start).count();
+		report.tokenize = percentiles(tokenize);
+		report.match    = percentiles(match);
+		report.verify   = percentiles(verify);
+		report.total    = percentiles(total);
+
+		return report;
+	}
+
+	static void print(std::ostream& os, const Report& report)
+	{
+		os << report.commands << " command lines, " << report.threads << " thread(s), " << report.seconds << " s" << std::endl;
+		os << std::left << std::setw(10) << "phase" << std::right << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(10) << "p999 ns" << std::endl;
+
+		const std::pair<const char*, const Percentiles*> phases[] = {
+			{ "tokenize", &report.tokenize }, { "match", &report.match }, { "verify", &report.verify }, { "total", &report.total }
+		};
+
+		for (const std::pair<const char*, const Percentiles*>& phase : phases)
+			os << std::left << std::setw(10) << phase.first << std::right << std::setw(10) << phase.second->p50 << std::setw(10) << phase.second->p99 << std::setw(10) << phase.second->p999 << std::endl;
+	}
+
+private:
+	static uint64_t nanoseconds(const std::chrono::steady_clock::duration& duration)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	}
+
+	static Percentiles percentiles(std::vector<uint64_t>& values)
+	{
+		Percentiles result = { 0, 0, 0 };
+
+		if (values.empty())
+			return result;
+
+		std::sort(values.begin(), values.end());
+
+		result.p50  = values[(values.size() - 1) * 500 / 1000];
+		result.p99  = values[(values.size() - 1) * 990 / 1000];
+		result.p999 = values[(values.size() - 1) * 999 / 1000];
+
+		return result;
+	}
+
+private:
+	std::vector<CommandLineOption> m_options;
+	std::vector<std::string> m_corpus;
+};
+
+int main(int argc, char** argv)
+{
+	CommandLineParser clp(argc, argv);
+
+	const CommandLineOption corpusOpt("-c", "--corpus", "File with one recorded command line per line", CLO::HasValue::Yes, CLO::Required::Yes);
+	const CommandLineOption schemaOpt("-s", "--schema", "File describing the options of the command lines", CLO::HasValue::Yes, CLO::Required::Yes);
+	const CommandLineOption threadsOpt("-t", "--threads", "Number of threads of the multi-threaded replay (0 = hardware concurrency)", "0");
+	const CommandLineOption iterationsOpt("-i", "--iterations", "Number of times the corpus is replayed", "1");
+
+	clp.addOption(corpusOpt);
+	clp.addOption(schemaOpt);
+	clp.addOption(threadsOpt);
+	clp.addOption(iterationsOpt);
+	clp.addHelpOption();
+	clp.parse();
+
+	CommandLineReplay replay(CommandLineReplay::loadSchema(clp.getValue(schemaOpt)));
+
+	if (!replay.loadCorpus(clp.getValue(corpusOpt)))
+	{
+		std::cerr << "ERROR: Unable to read corpus (" << clp.getValue(corpusOpt) << ")" << std::endl;
+		return -1;
+	}
+
+	const size_t iterations = clp.getValueAs<size_t>(iterationsOpt);
+
+	CommandLineReplay::print(std::cout, replay.run(1, iterations));
+	std::cout << std::endl;
+	CommandLineReplay::print(std::cout, replay.run(clp.getValueAs<size_t>(threadsOpt), iterations));
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ *  File: replicas.cpp
+ *  Copyright (c) 2023 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+// NUMA replica benchmark
+// Replicates a snapshot with many options via CommandLineReplicas and reads all of its values
+// from one thread per node, once from the replica local to the node and once from the replica
+// of the first node, i.e., what every thread would read without replication. The average time
+// per read of the snapshot is printed per node.
+//
+// Usage: replicas [--options <count>] [--reads <count>]
+
+#include "CommandLineParser.h"
+
+namespace
+{
+// CPUs per node as listed in sysfs, a single entry without CPUs if the nodes are unknown
+std::vector<std::vector<std::pair<size_t, size_t>>> readNodes()
+{
+	std::vector<std::vector<std::pair<size_t, size_t>>> nodes;
+
+#ifdef __linux__
+	for (const std::pair<size_t, size_t>& range : HostInfo::readRangeList("/sys/devices/system/node/online"))
+	{
+		for (size_t node = range.first; node <= range.second; node++)
+		{
+			const std::vector<std::pair<size_t, size_t>> cpus = HostInfo::readRangeList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+
+			// Same as CommandLineReplicas, nodes without CPUs are skipped
+			if (!cpus.empty())
+				nodes.push_back(cpus);
+		}
+	}
+#endif
+
+	if (nodes.empty())
+		nodes.push_back({});
+
+	return nodes;
+}
+
+void bindToCpus(const std::vector<std::pair<size_t, size_t>>& cpus)
+{
+#ifdef __linux__
+	if (cpus.empty())
+		return;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	for (const std::pair<size_t, size_t>& range : cpus)
+	{
+		for (size_t cpu = range.first; cpu <= range.second && cpu < CPU_SETSIZE; cpu++)
+			CPU_SET(cpu, &set);
+	}
+
+	sched_setaffinity(0, sizeof(set), &set);
+#else
+	(void)cpus;
+#endif
+}
+
+// Average time in ns per call of reader(snapshot)
+double measure(const CommandLineSnapshot& snapshot, const std::function<size_t(const CommandLineSnapshot&)>& reader, const size_t& reads, size_t& sink)
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < reads; i++)
+		sink += reader(snapshot);
+
+	const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	return ns / static_cast<double>((std::max)(static_cast<size_t>(1), reads));
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	CommandLineParser clp(argc, argv);
+
+	const CommandLineOption optionsOpt("-o", "--options", "Number of options in the snapshot", "10000");
+	const CommandLineOption readsOpt("-r", "--reads", "Number of times each thread reads all values of the snapshot", "100");
+
+	clp.addOption(optionsOpt);
+	clp.addOption(readsOpt);
+	clp.addHelpOption();
+	clp.parse(false);
+
+	const size_t options = clp.getValueAs<size_t>(optionsOpt);
+	const size_t reads   = clp.getValueAs<size_t>(readsOpt);
+
+	CommandLineSnapshot snapshot;
+	std::vector<std::string> names;
+
+	for (size_t i = 0; i < options; i++)
+	{
+		names.push_back("--option-" + std::to_string(i));
+		snapshot.add({ names.back() }, "value-" + std::to_string(i), true);
+	}
+
+	const std::function<size_t(const CommandLineSnapshot&)> reader = [&names](const CommandLineSnapshot& replica) {
+		size_t length = 0;
+
+		for (const std::string& name : names)
+			length += replica.getValue(name).size();
+
+		return length;
+	};
+
+	const std::vector<std::vector<std::pair<size_t, size_t>>> nodes = readNodes();
+	const CommandLineReplicas<CommandLineSnapshot> replicas(snapshot);
+	std::vector<std::pair<double, double>> results(nodes.size());
+	std::vector<std::thread> threads;
+	std::atomic<size_t> sink(0);
+
+	// One thread per node, the main thread is neither used nor bound
+	for (size_t node = 0; node < nodes.size(); node++)
+	{
+		threads.emplace_back([&, node]() {
+			size_t local = 0;
+			bindToCpus(nodes[node]);
+
+			results[node].first  = measure(*replicas.local(), reader, reads, local);
+			results[node].second = measure(*replicas.replica(0), reader, reads, local);
+
+			sink += local;
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	std::cout << "Replicas: " << replicas.count() << ", nodes: " << nodes.size() << ", options: " << options << " (" << sink.load() << " bytes read)" << std::endl;
+
+	for (size_t node = 0; node < nodes.size(); node++)
+		std::cout << "  node " << node << ": local " << std::fixed << std::setprecision(1) << results[node].first << " ns, first node " << results[node].second << " ns" << std::endl;
+
+	return 0;
+}